@@ -0,0 +1,21 @@
+# writes the current commit into a header, run at build time so results
+# stay stamped with HEAD after commits without a reconfigure
+execute_process(
+    COMMAND git rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE commit
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET
+)
+if(NOT commit)
+    set(commit "unknown")
+endif()
+
+# rewritten only on change, unchanged HEAD doesn't rebuild the bench
+set(content "#pragma once\n#define EMPY_BENCH_COMMIT \"${commit}\"\n")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} previous)
+endif()
+if(NOT "${previous}" STREQUAL "${content}")
+    file(WRITE ${OUTPUT} "${content}")
+endif()
@@ -0,0 +1,256 @@
+#include "Harness.h"
+// generated at build time, "unknown" outside git
+#include "Commit.h"
+
+using namespace Empy;
+
+// bench files live outside the project resources
+static std::filesystem::path BenchPath(const std::string& name)
+{
+    auto directory = std::filesystem::temp_directory_path() / "EmpyBench";
+    std::filesystem::create_directories(directory);
+    return directory / name;
+}
+
+static void BenchMath(BenchHarness& bench)
+{
+    Transform3D transform;
+    transform.Translate = glm::vec3(1.0f, 2.0f, 3.0f);
+    transform.Scale = glm::vec3(2.0f);
+
+    // inputs change every call, nothing folds into a constant
+    bench.Run("Transform3D::Matrix/euler", [&]
+    {
+        transform.Rotation.y += 0.1f;
+        DoNotOptimize(transform.Matrix());
+    });
+
+    transform.SetQuaternion(glm::quat(glm::vec3(0.1f, 0.2f, 0.3f)));
+    bench.Run("Transform3D::Matrix/quat", [&]
+    {
+        transform.Translate.x += 0.1f;
+        DoNotOptimize(transform.Matrix());
+    });
+
+    Camera3D camera;
+    transform.SetEuler(glm::vec3(10.0f, 20.0f, 0.0f));
+    bench.Run("Camera3D::View", [&]
+    {
+        transform.Translate.z += 0.1f;
+        DoNotOptimize(camera.View(transform));
+    });
+
+    float ratio = 16.0f / 9.0f;
+    bench.Run("Camera3D::Projection", [&]
+    {
+        ratio += 1e-6f;
+        DoNotOptimize(camera.Projection(ratio));
+    });
+}
+
+static void BenchAnimator(BenchHarness& bench)
+{
+    const std::string source = "Resources/Models/Walking.fbx";
+    if(!bench.Enabled("Animator::Animate/Walking")) { return; }
+    if(!std::filesystem::exists(source))
+    {
+        std::printf("skipped Animator::Animate, missing %s\n", source.c_str());
+        return;
+    }
+
+    // cpu side rig only, no gl context needed
+    SkeletalModel model(source, true);
+    bench.Run("Animator::Animate/Walking", [&]
+    {
+        DoNotOptimize(model.Animate(1.0f / 60.0f));
+    });
+}
+
+static void BenchEvents(BenchHarness& bench)
+{
+    constexpr uint32_t EVENTS = 64u;
+    EventDispatcher dispatcher;
+    int64_t sum = 0;
+
+    dispatcher.AttachCallback<KeyPressEvent>([&sum] (const KeyPressEvent& e) { sum += e.Key; }, 1u);
+    dispatcher.AttachCallback<MouseMotionEvent>([&sum] (const MouseMotionEvent& e)
+    {
+        sum += static_cast<int64_t>(e.TaregtX);
+    }, 1u);
+
+    bench.Run("EventDispatcher::PostPoll/64", [&]
+    {
+        for(uint32_t i = 0u; i < EVENTS; i += 2u)
+        {
+            dispatcher.PostEvent<KeyPressEvent>(static_cast<int32_t>(i));
+            dispatcher.PostEvent<MouseMotionEvent>(i * 1.0, i * 2.0);
+        }
+        dispatcher.PollEvents();
+        DoNotOptimize(sum);
+    }, EVENTS);
+}
+
+static void BenchAssets(BenchHarness& bench)
+{
+    constexpr uint32_t ASSETS = 1024u;
+    AssetRegistry assets(true);
+    std::vector<AssetID> uids(ASSETS);
+    for(auto& uid : uids) { uid = assets.AddMaterial(RandomU64(), "Material")->UID; }
+
+    uint32_t index = 0u;
+    bench.Run("AssetRegistry::Get/hit", [&]
+    {
+        auto& material = assets.Get<MaterialAsset>(uids[index++ & (ASSETS - 1u)]);
+        DoNotOptimize(material.Data);
+    });
+
+    bench.Run("AssetRegistry::Get/miss", [&]
+    {
+        auto& material = assets.Get<MaterialAsset>(uids[index++ & (ASSETS - 1u)] + 1u);
+        DoNotOptimize(material.Data);
+    });
+}
+
+static void BenchViews(BenchHarness& bench)
+{
+    std::vector<uint32_t> counts = { 1000u, 100000u, 1000000u };
+    auto enabled = std::any_of(counts.begin(), counts.end(), [&bench] (uint32_t count)
+    {
+        return bench.Enabled("EnttView/" + std::to_string(count));
+    });
+    if(!enabled) { return; }
+
+    // empty project, the view sees bench entities only
+    DataSerializer serializer;
+    EntityRegistry empty;
+    AssetRegistry noAssets(true);
+    AppConfig config;
+    config.Headless = true;
+    config.HitchFrames = 0u;
+    config.Scene = BenchPath("empty_scene.yaml").string();
+    config.Assets = BenchPath("empty_assets.yaml").string();
+    serializer.Serialize(empty, config.Scene);
+    serializer.Serialize(noAssets, config.Assets);
+
+    Application app(config);
+    std::vector<EntityID> entities;
+
+    for(auto count : counts)
+    {
+        auto name = "EnttView/" + std::to_string(count);
+        if(!bench.Enabled(name)) { continue; }
+
+        while(entities.size() < count)
+        {
+            auto entity = app.CreateEntt<Entity>();
+            entity.Attach<TransformComponent>().Transform.Translate.x = 1.0f;
+            entities.push_back(entity.ID());
+        }
+
+        bench.Run(name, [&]
+        {
+            float sum = 0.0f;
+            app.EnttView<Entity, TransformComponent>([&sum] (auto entity, auto& comp)
+            {
+                sum += comp.Transform.Translate.x;
+            });
+            DoNotOptimize(sum);
+        }, count);
+    }
+}
+
+static void BenchScripts(BenchHarness& bench)
+{
+    constexpr uint32_t SCRIPTS = 1000u;
+    if(!bench.Enabled("Script::OnUpdate/1000")) { return; }
+
+    // minimal script, measures dispatch rather than script work
+    auto source = BenchPath("BenchScript.lua");
+    {
+        std::ofstream stream(source);
+        stream << "function BenchScript.OnStart(self) self.Time = 0.0 end\n"
+               << "function BenchScript.OnUpdate(self, dt) self.Time = self.Time + dt end\n"
+               << "function BenchScript.OnDestroy(self) end\n";
+    }
+
+    EventDispatcher dispatcher;
+    EntityRegistry scene;
+    AppWindow window(&dispatcher);
+    ScriptContext scripts(&scene, &window, nullptr);
+
+    auto name = scripts.LoadScript(source.string());
+    for(uint32_t i = 0u; i < SCRIPTS; i++)
+    {
+        Entity entity(&scene);
+        entity.Attach<TransformComponent>();
+        entity.Attach<ScriptComponent>();
+        scripts.AttachScript(entity, name);
+    }
+
+    bench.Run("Script::OnUpdate/1000", [&]
+    {
+        scene.view<ScriptComponent>().each([] (auto entity, auto& script)
+        {
+            if(script.Instance) { script.Instance->OnUpdate(1.0f / 60.0f); }
+        });
+    }, SCRIPTS);
+
+    // script handles must go before the lua state
+    scene.clear();
+}
+
+static void BenchSerializer(BenchHarness& bench)
+{
+    constexpr uint32_t ENTITIES = 1000u;
+    if(!bench.Enabled("DataSerializer::RoundTrip/1000")) { return; }
+
+    EntityRegistry scene;
+    for(uint32_t i = 0u; i < ENTITIES; i++)
+    {
+        Entity entity(&scene);
+        entity.Attach<InfoComponent>().Name = "Entity" + std::to_string(i);
+        entity.Attach<TransformComponent>().Transform.Translate = glm::vec3(i * 1.0f);
+        entity.Attach<ModelComponent>();
+    }
+
+    auto path = BenchPath("scene.yaml").string();
+    DataSerializer serializer;
+    EntityRegistry loaded;
+
+    bench.Run("DataSerializer::RoundTrip/1000", [&]
+    {
+        serializer.Serialize(scene, path);
+        serializer.Deserialize(loaded, path);
+        DoNotOptimize(loaded.storage<InfoComponent>().size());
+    }, ENTITIES);
+}
+
+// EmpyBench [--filter name] [--json path] [--samples n] [--warmup ms]
+int32_t main(int32_t argc, char** argv)
+{
+    BenchOptions options;
+    for(int32_t i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if(option == "--filter") { options.Filter = argv[i + 1]; }
+        else if(option == "--json") { options.Json = argv[i + 1]; }
+        else if(option == "--samples") { options.Samples = static_cast<uint32_t>(std::stoul(argv[i + 1])); }
+        else if(option == "--warmup") { options.Warmup = std::stod(argv[i + 1]); }
+    }
+
+    // same inputs on every run
+    SeedRandom(0x454d5059u);
+
+    // timing scopes would measure themselves
+    Profiler::Get().SetEnabled(false);
+
+    BenchHarness bench(options);
+    BenchMath(bench);
+    BenchAnimator(bench);
+    BenchEvents(bench);
+    BenchAssets(bench);
+    BenchViews(bench);
+    BenchScripts(bench);
+    BenchSerializer(bench);
+    return bench.WriteJson(EMPY_BENCH_COMMIT) ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <Empy.h>
+#include <numeric>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+
+namespace Empy
+{
+    // keeps the compiler from dropping a computed value
+    template <typename T>
+    EMPY_INLINE void DoNotOptimize(const T& value)
+    {
+    #if defined(_MSC_VER)
+        static const void* volatile sSink;
+        sSink = &value;
+    #else
+        asm volatile("" : : "r,m"(value) : "memory");
+    #endif
+    }
+
+    // timings of one benchmark in nanoseconds per operation
+    struct BenchResult
+    {
+        std::string Name;
+        // items processed by one operation
+        uint64_t Items = 1u;
+        // operations per sample
+        uint64_t Batch = 1u;
+        uint32_t Samples = 0u;
+        double Mean = 0.0;
+        double Min = 0.0;
+        double P50 = 0.0;
+        double P90 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+    };
+
+    struct BenchOptions
+    {
+        // substring of benchmark names to run, empty runs all
+        std::string Filter;
+        // results file, empty skips
+        std::string Json;
+        uint32_t Samples = 50u;
+        // milliseconds
+        double Warmup = 200.0;
+        double SampleTime = 10.0;
+    };
+
+    // warm-up, batched samples and percentiles per benchmark
+    struct BenchHarness
+    {
+        using Clock = std::chrono::steady_clock;
+
+        EMPY_INLINE BenchHarness(const BenchOptions& options):
+            m_Options(options)
+        {
+            std::printf("%-36s %12s %12s %12s %12s\n", "benchmark", "p50 ns", "p90 ns", "p99 ns", "ns/item");
+        }
+
+        EMPY_INLINE bool Enabled(const std::string& name) const
+        {
+            return m_Options.Filter.empty() || name.find(m_Options.Filter) != std::string::npos;
+        }
+
+        // task() is one operation over items elements
+        template <typename Task>
+        EMPY_INLINE void Run(const std::string& name, Task&& task, uint64_t items = 1u)
+        {
+            if(!Enabled(name)) { return; }
+
+            // warm caches and estimate the cost of one operation
+            uint64_t count = 0u;
+            auto start = Clock::now();
+            double elapsed = 0.0;
+            while(elapsed < m_Options.Warmup * 1e6 || count == 0u)
+            {
+                task();
+                count++;
+                elapsed = Nanoseconds(start, Clock::now());
+            }
+
+            // batch fills a sample, keeps the timer well above its resolution
+            auto cost = elapsed / static_cast<double>(count);
+            auto batch = static_cast<uint64_t>(std::max(1.0, m_Options.SampleTime * 1e6 / cost));
+
+            std::vector<double> times(std::max(m_Options.Samples, 1u));
+            for(auto& time : times)
+            {
+                auto begin = Clock::now();
+                for(uint64_t i = 0u; i < batch; i++) { task(); }
+                time = Nanoseconds(begin, Clock::now()) / static_cast<double>(batch);
+            }
+            std::sort(times.begin(), times.end());
+
+            BenchResult result;
+            result.Name = name;
+            result.Items = std::max<uint64_t>(items, 1u);
+            result.Batch = batch;
+            result.Samples = static_cast<uint32_t>(times.size());
+            result.Mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+            result.Min = times.front();
+            result.P50 = Percentile(times, 0.50);
+            result.P90 = Percentile(times, 0.90);
+            result.P99 = Percentile(times, 0.99);
+            result.Max = times.back();
+            m_Results.push_back(result);
+
+            std::printf("%-36s %12.1f %12.1f %12.1f %12.2f\n", name.c_str(),
+                result.P50, result.P90, result.P99, result.P50 / result.Items);
+            std::fflush(stdout);
+        }
+
+        // one object per benchmark, stamped with the build's commit
+        EMPY_INLINE bool WriteJson(const std::string& commit) const
+        {
+            if(m_Options.Json.empty()) { return true; }
+
+            std::ofstream stream(m_Options.Json);
+            if(!stream)
+            {
+                std::fprintf(stderr, "failed to write results: %s\n", m_Options.Json.c_str());
+                return false;
+            }
+
+            stream << "{\n\"commit\":\"" << commit << "\",\n\"unit\":\"ns/op\",\n\"results\":[";
+            for(size_t i = 0u; i < m_Results.size(); i++)
+            {
+                auto& result = m_Results[i];
+                stream << (i ? "," : "") << "\n{\"name\":\"" << result.Name
+                    << "\",\"items\":" << result.Items << ",\"batch\":" << result.Batch
+                    << ",\"samples\":" << result.Samples << ",\"mean\":" << result.Mean
+                    << ",\"min\":" << result.Min << ",\"p50\":" << result.P50
+                    << ",\"p90\":" << result.P90 << ",\"p99\":" << result.P99
+                    << ",\"max\":" << result.Max << "}";
+            }
+            stream << "\n]}\n";
+            return true;
+        }
+
+    private:
+        EMPY_INLINE static double Nanoseconds(Clock::time_point begin, Clock::time_point end)
+        {
+            return std::chrono::duration<double, std::nano>(end - begin).count();
+        }
+
+        // nearest rank on sorted samples
+        EMPY_INLINE static double Percentile(const std::vector<double>& sorted, double p)
+        {
+            auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::clamp<size_t>(rank, 1u, sorted.size()) - 1u];
+        }
+
+    private:
+        std::vector<BenchResult> m_Results;
+        BenchOptions m_Options;
+    };
+}
@@ -11,8 +11,10 @@ struct TransformControl : IControl<TransformComponent>
     EMPY_INLINE void OnBody(GuiContext* context, Entity& entity) 
 	{
         auto& data = entity.template Get<TransformComponent>().Transform;
+        glm::vec3 rotation = data.Euler();
         InputVec3("Translate", &data.Translate);
-        InputVec3("Rotation", &data.Rotation);
+        // editing drops the physics quaternion
+        if(InputVec3("Rotation", &rotation)) { data.SetEuler(rotation); }
         InputVec3("Scale", &data.Scale);    
     }
 
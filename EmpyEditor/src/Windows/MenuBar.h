@@ -39,6 +39,24 @@ struct MenuBarWindow : IWidget
                 if (ImGui::MenuItem(ICON_FA_TRASH " Delete", "Delete")) {}
                 ImGui::EndMenu();
             }
+            if (ImGui::BeginMenu("Profile")) 
+			{
+				auto& sampler = SampleProfiler::Get();
+                if (ImGui::MenuItem(ICON_FA_FIRE " Start Sampling", nullptr, false, !sampler.IsRunning())) 
+				{
+					sampler.Start(1000u);
+				}
+                if (ImGui::MenuItem(ICON_FA_STOP " Stop Sampling", nullptr, false, sampler.IsRunning())) 
+				{
+					sampler.WriteFolded("Resources/Profiles/samples.folded");
+				}
+                ImGui::Separator();
+                if (ImGui::MenuItem(ICON_FA_STOPWATCH " Export Trace")) 
+				{
+					Profiler::Get().ExportTrace("Resources/Profiles/trace.json");
+				}
+                ImGui::EndMenu();
+            }
             if (ImGui::BeginMenu("Settings")) 
 			{
                 if (ImGui::MenuItem(ICON_FA_PALETTE " Theme")) {}
@@ -3,22 +3,47 @@
 
 namespace Empy
 {
+    // lights gathered for rendering
+    struct SceneLights
+    {
+        std::vector<std::pair<DirectLight, Transform3D>> Direct;
+        std::vector<std::pair<PointLight, Transform3D>> Point;
+        std::vector<std::pair<SpotLight, Transform3D>> Spot;
+    };
+
+    // model resolved by a render worker, submitted on the main thread
+    struct ModelSubmit
+    {
+        Model3D* Model = nullptr;
+        Material* Mtl = nullptr;
+        glm::mat4 World = glm::mat4(1.0f);
+    };
+
     struct Application : AppInterface
     {
         // runs application main loop
         EMPY_INLINE void RunContext(bool showFrame)
         {          
+            if(!m_Context->Renderer)
+            {
+                RunHeadless();
+                return;
+            }
+
             // application main loop
             while(m_Context->Window->PollEvents())
             {   
                 // set delta time
                 UpdateDeltaTime();
 
-                // update scene, 
-                UpdateScene();
+                // update and render scene
+                m_Context->Scheduler->Run(*m_Context->Jobs, m_Context->Scene);
+
+                // actor writes outside the stages need an idle scene
+                m_Context->Physics->FetchResults();
 
-                // render scene 
-                RenderScene();
+                // apply deferred entity changes
+                m_Context->Commands->Flush(m_Context->Scene);
 
                 for(auto layer : m_Context->Layers)
                 {
@@ -27,6 +52,8 @@ namespace Empy
 
                 // show only for game
                 m_Context->Renderer->ShowFrame(showFrame);
+                EMPY_PROFILE_FRAME();
+                RecordFrame();
             }
         }
 
@@ -37,57 +64,171 @@ namespace Empy
         }
 
         // creates application context
-        EMPY_INLINE Application() 
+        EMPY_INLINE Application(const AppConfig& config = AppConfig()) 
         {
             // create application context
             m_LayerID = TypeID<Application>();                   
-            m_Context = new AppContext();
+            m_Context = new AppContext(config);
+
+            // main thread joins the workers in stack samples
+            SampleProfiler::Get().RegisterThread();
 
             // register callbacks
             RegisterCallbacks();
 
             // start scene
             StartScene();
+
+            // build frame graph
+            RegisterStages();
         }
 
     private:   
-        // registers event callback functions
-        EMPY_INLINE void RegisterCallbacks()
+        // fixed ticks without window, prints stage timings at exit
+        EMPY_INLINE void RunHeadless()
         {
-            // set physics event callback
-            m_Context->Physics->SetEventCallback([this] (auto e)
+            auto& config = m_Context->Config;
+            auto step = std::chrono::duration<double>(1.0 / std::max(1.0, config.TickRate));
+            auto next = std::chrono::steady_clock::now();
+
+            // total, min and max per stage (ms)
+            std::vector<std::array<double, 3>> stats;
+            uint32_t ticks = 0u;
+
+            while(config.Ticks == 0u || ticks < config.Ticks)
             {
-                // do not report if invalid entities        
-                if(!m_Context->Scene.valid(e.Entity1) || 
-                !m_Context->Scene.valid(e.Entity2)) 
-                { return; }
+                // only a finished replay stops a headless run
+                if(!m_Context->Window->PollEvents()) { break; }
+                UpdateDeltaTime();
 
-                PostTask([this, e] 
-                {
-                    auto entity1 = ToEntt<Entity>(e.Entity1);
-                    auto entity2 = ToEntt<Entity>(e.Entity2);
+                m_Context->Scheduler->Run(*m_Context->Jobs, m_Context->Scene);
+                m_Context->Physics->FetchResults();
+                m_Context->Commands->Flush(m_Context->Scene);
 
-                    // entity 1 call script on-collision  
-                    if(entity1.template Has<ScriptComponent>())
-                    {
-                        entity1.template Get<ScriptComponent>().
-                        Instance->OnCollision(e.Entity2);
-                    }
+                for(auto layer : m_Context->Layers)
+                {
+                    layer->OnUpdate();
+                }
+                EMPY_PROFILE_FRAME();
+                RecordFrame();
 
-                    // entity 2 call script on-collision                  
-                    if(entity2.template Has<ScriptComponent>())
-                    {
-                        entity2.template Get<ScriptComponent>().
-                        Instance->OnCollision(e.Entity1);
-                    }
+                size_t index = 0u;
+                StageView([&] (auto& stage)
+                {
+                    if(stats.size() <= index) { stats.push_back({ 0.0, stage.Time, stage.Time }); }
+                    auto& stat = stats[index++];
+                    stat[0] += stage.Time;
+                    stat[1] = std::min(stat[1], stage.Time);
+                    stat[2] = std::max(stat[2], stage.Time);
                 });
+                ticks++;
+
+                if(config.Realtime)
+                {
+                    next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(step);
+                    std::this_thread::sleep_until(next);
+                }
+            }
+
+            // logging may be compiled out, stats go to stdout
+            size_t index = 0u;
+            std::printf("%u ticks at %.1f hz\n", ticks, config.TickRate);
+            std::printf("%-16s %10s %10s %10s\n", "stage", "avg ms", "min ms", "max ms");
+            StageView([&] (auto& stage)
+            {
+                if(index >= stats.size()) { return; }
+                auto& stat = stats[index++];
+                std::printf("%-16s %10.3f %10.3f %10.3f\n", stage.Name.c_str(), 
+                    stat[0] / std::max(1u, ticks), stat[1], stat[2]);
             });
+        }
+
+        // feeds the hitch window at the frame boundary
+        EMPY_INLINE void RecordFrame()
+        {
+            auto& hitches = *m_Context->Hitches;
+            if(!hitches.IsEnabled()) { return; }
+
+            StageView([&hitches] (auto& stage) { hitches.Stage(stage.Name.c_str(), stage.Time); });
+            hitches.Counter("Entities", m_Context->Scene.storage<InfoComponent>().size());
+            hitches.Counter("MovingBodies", m_Moving.size());
+            hitches.Counter("PhysicsSteps", m_Context->Physics->Steps());
+            hitches.Counter("Contacts", m_Contacts);
+            hitches.Counter("LuaMemory", m_Context->Scripts->MemoryUsed());
+            if(m_Context->Renderer) 
+            { 
+                hitches.Counter("DrawCalls", m_Context->Renderer->DrawCalls()); 
+                hitches.Counter("Instances", m_Context->Renderer->InstanceCount()); 
+
+                // gl state changes issued and avoided by the cache
+                auto& issued = GLState::Get().Issued();
+                auto& skipped = GLState::Get().Skipped();
+                hitches.Counter("StateChanges", issued.Programs + issued.Textures + issued.Arrays + issued.Uniforms);
+                hitches.Counter("ProgramSkips", skipped.Programs);
+                hitches.Counter("TextureSkips", skipped.Textures);
+                hitches.Counter("ArraySkips", skipped.Arrays);
+                hitches.Counter("UniformSkips", skipped.Uniforms);
+
+                // vertex and index arenas
+                hitches.Counter("GeometryBytes", GeometryUsage().Used);
+                hitches.Counter("GeometryReserved", GeometryUsage().Reserved);
+            }
+            hitches.EndFrame();
+        }
+
+        // registers frame stages and their data access
+        EMPY_INLINE void RegisterStages()
+        {
+            auto& scheduler = *m_Context->Scheduler;
+
+            // takes last frame's async step, fetched before events and deferred writes
+            scheduler.AddStage("PhysicsFetch", [this] { FetchPhysics(); })
+            .Write<RigidBodyComponent, TransformComponent>().Read<WorldMatrixComponent>().MainThread();
+
+            // lua is single threaded and may touch any component
+            scheduler.AddStage("Scripts", [this] { UpdateScripts(); })
+            .MainThread().Exclusive();
+
+            // contacts are buffered and delivered to scripts next frame
+            scheduler.AddStage("Physics", [this] { StepPhysics(); })
+            .Write<RigidBodyComponent>().Read<WorldMatrixComponent>().MainThread();
+
+            scheduler.AddStage("PhysicsSync", [this] { SyncPhysics(); })
+            .Read<RigidBodyComponent, WorldMatrixComponent>().Write<TransformComponent>();
+
+            // emplaces world matrices when the hierarchy changed
+            scheduler.AddStage("Hierarchy", [this] { m_Context->Hierarchy->Update(); })
+            .Read<InfoComponent, TransformComponent>().Write<WorldMatrixComponent>()
+            .MainThread();
+
+            scheduler.AddStage("Animation", [this] { UpdateAnimations(); })
+            .Read<ModelComponent>();
+
+            // lights and drawing need a renderer
+            if(!m_Context->Renderer) { return; }
+
+            scheduler.AddStage("Lights", [this] { GatherLights(); })
+            .Read<TransformComponent, WorldMatrixComponent, DirectLightComponent>()
+            .Read<PointLightComponent, SpotLightComponent>();
 
+            // opengl calls must stay on the context thread
+            scheduler.AddStage("Render", [this] { RenderScene(); })
+            .Read<TransformComponent, WorldMatrixComponent, ModelComponent>()
+            .Read<CameraComponent, SkyboxComponent>()
+            .After("Animation").After("Lights")
+            .MainThread();
+        }
+
+        // registers event callback functions
+        EMPY_INLINE void RegisterCallbacks()
+        {
             // attach window resize event callback
             AttachCallback<WindowResizeEvent>([this] (auto e) 
             {
+                m_Context->Hitches->Mark("WindowResize");
+
                 // resire renderer frame buffer
-                m_Context->Renderer->Resize(e.Width, e.Height);
+                if(m_Context->Renderer) { m_Context->Renderer->Resize(e.Width, e.Height); }
 
                 // call scripts resize function
                 EnttView<Entity, ScriptComponent>([e] 
@@ -103,6 +244,8 @@ namespace Empy
             // register mouse down callback
             AttachCallback<MouseDownEvent>([this] (auto e) 
             {
+                m_Context->Hitches->Mark("MouseDown");
+
                 // call scripts mouse down callback
                 EnttView<Entity, ScriptComponent>([e] 
                 (auto entity, auto& script) 
@@ -117,6 +260,8 @@ namespace Empy
             // register key down callback
             AttachCallback<KeyPressEvent>([this] (auto e) 
             {
+                m_Context->Hitches->Mark("KeyPress");
+
                 // call scripts mouse down callback
                 EnttView<Entity, ScriptComponent>([e] 
                 (auto entity, auto& script) 
@@ -132,10 +277,26 @@ namespace Empy
         // computes frame delta time value
         EMPY_INLINE void UpdateDeltaTime()
         {
-            static double sLastTime = glfwGetTime();
-            double currentTime = glfwGetTime();
-            m_Context->DeltaTime = (currentTime - sLastTime);         
-            sLastTime = currentTime;
+            auto& log = m_Context->Window->Log();
+            if(log.IsReplaying())
+            {
+                m_Context->DeltaTime = log.DeltaTime();
+            }
+            // headless ticks are fixed
+            else if(m_Context->Window->IsHeadless())
+            {
+                m_Context->DeltaTime = 1.0 / std::max(1.0, m_Context->Config.TickRate);
+            }
+            else
+            {
+                static double sLastTime = glfwGetTime();
+                double currentTime = glfwGetTime();
+                m_Context->DeltaTime = (currentTime - sLastTime);         
+                sLastTime = currentTime;
+            }
+
+            // inputs polled this frame go out with its delta
+            log.EndFrame(m_Context->DeltaTime);
         }
        
         // creates entities with components
@@ -223,10 +384,11 @@ namespace Empy
         //     m_Context->Renderer->ShowFrame();
         // }      
 
-        // updates physcis, scripts, etc.
-        EMPY_INLINE void UpdateScene()
+        // updates script instances
+        EMPY_INLINE void UpdateScripts()
         {
-            // update script instances
+            DispatchCollisions();
+
             EnttView<Entity, ScriptComponent>([this] (auto entity, auto& script) 
             {
                 if(script.Instance)
@@ -234,104 +396,305 @@ namespace Empy
                     script.Instance->OnUpdate(m_Context->DeltaTime);
                 }
             });
+        }
+
+        // delivers last step's contacts in one pass
+        EMPY_INLINE void DispatchCollisions()
+        {
+            auto& scene = m_Context->Scene;
+            m_Contacts = m_Context->Physics->DispatchEvents([&scene] (const PxPayload& e)
+            {
+                // either entity may be gone by now
+                auto notify = [&scene] (EntityID entity, EntityID other)
+                {
+                    if(!scene.valid(entity)) { return; }
+                    if(auto script = scene.try_get<ScriptComponent>(entity))
+                    {
+                        if(script->Instance && script->Instance->HasCollision())
+                        {
+                            script->Instance->OnCollision(other);
+                        }
+                    }
+                };
 
-            // compute physics state
-            m_Context->Physics->Simulate(1, m_Context->DeltaTime);      
+                notify(e.Entity1, e.Entity2);
+                notify(e.Entity2, e.Entity1);
+            });
+        }
 
-            // update physics physics
-            EnttView<Entity, RigidBodyComponent>([this] (auto entity, auto& comp) 
+        // runs due fixed steps and queued scene queries
+        EMPY_INLINE void StepPhysics()
+        {
+            auto& physics = *m_Context->Physics;
+            auto steps = physics.Accumulate(m_Context->DeltaTime);
+            if(steps == 0u) 
             { 
-                auto& transform = entity.template Get<TransformComponent>().Transform;     
-                auto pose = comp.RigidBody.Actor->getGlobalPose();
-                glm::quat rot(pose.q.x, pose.q.y, pose.q.z, pose.q.w);
-                transform.Rotation = glm::degrees(glm::eulerAngles(rot));
-                transform.Translate = PxToVec3(pose.p);
+                physics.Queries().Execute();
+                return; 
+            }
+
+            // last step runs while the frame renders
+            if(physics.IsAsync())
+            {
+                physics.Simulate(steps - 1u, physics.StepTime());
+                physics.Queries().Execute();
+                physics.BeginSimulate(physics.StepTime());
+                return;
+            }
+
+            physics.ClearActiveEntities();
+            physics.Simulate(steps - 1u, physics.StepTime());
+
+            // only bodies that moved can differ from their last pose
+            if(physics.IsFixedStep())
+            {
+                MergeMoving(physics.ActiveEntities());
+                ForEachMoving([] (auto& body, auto& transform, auto parent) 
+                {
+                    body.Previous = body.Actor->getGlobalPose();
+                });
+                physics.ClearActiveEntities();
+            }
+
+            physics.Simulate(1u, physics.StepTime());
+            physics.Queries().Execute();
+        }
+
+        // double buffers poses of the completed async step
+        EMPY_INLINE void FetchPhysics()
+        {
+            auto& physics = *m_Context->Physics;
+            if(!physics.TakeResults()) { return; }
+            MergeMoving(physics.ActiveEntities());
+
+            ForEachMoving([] (auto& body, auto& transform, auto parent) 
+            {
+                body.Previous = body.Current;
+                body.Current = body.Actor->getGlobalPose();
+
+                // came to rest, no more blending
+                if(body.Previous == body.Current) 
+                { 
+                    ApplyPose(transform, body.Current, parent); 
+                }
+            });
+
+            m_Moving = physics.ActiveEntities();
+            physics.ClearActiveEntities();
+        }
+
+        // copies interpolated poses of active bodies to transforms
+        EMPY_INLINE void SyncPhysics()
+        {
+            auto& physics = *m_Context->Physics;
+            auto fixed = physics.IsFixedStep();
+            auto alpha = physics.Alpha();
+
+            // async poses are only read at fetch
+            auto steps = physics.IsAsync() ? 0u : physics.Steps();
+            if(steps > 0u) { MergeMoving(physics.ActiveEntities()); }
+
+            // poses are world space, parented bodies convert to local
+            ForEachMoving([steps, alpha, fixed] (auto& body, auto& transform, auto parent) 
+            { 
+                if(steps > 0u) { body.Current = body.Actor->getGlobalPose(); }
+                if(!fixed) { body.Previous = body.Current; }
+
+                ApplyPose(transform, PxInterpolate(body.Previous, body.Current, alpha), parent);
             }); 
 
+            // bodies asleep after the last step are at rest
+            if(steps > 0u) { m_Moving = physics.ActiveEntities(); }
+        }
+
+        // parent is the parent's world matrix, null for roots
+        EMPY_INLINE static void ApplyPose(Transform3D& transform, const PxTransform& pose, const glm::mat4* parent)
+        {
+            auto rotation = glm::quat(pose.q.w, pose.q.x, pose.q.y, pose.q.z);
+            auto position = PxToVec3(pose.p);
+            if(parent)
+            {
+                // parent scale is divided out of the local rotation
+                auto local = glm::inverse(*parent) * (glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation));
+                auto basis = glm::mat3(glm::normalize(glm::vec3(local[0])), 
+                    glm::normalize(glm::vec3(local[1])), glm::normalize(glm::vec3(local[2])));
+                rotation = glm::quat_cast(basis);
+                position = glm::vec3(local[3]);
+            }
+            transform.SetQuaternion(rotation);
+            transform.Translate = position;
+        }
+
+        // adds entities to the moving set, keeps it sorted and unique
+        EMPY_INLINE void MergeMoving(const std::vector<EntityID>& entities)
+        {
+            if(entities.empty()) { return; }
+            auto middle = m_Moving.insert(m_Moving.end(), entities.begin(), entities.end());
+            std::inplace_merge(m_Moving.begin(), middle, m_Moving.end());
+            m_Moving.erase(std::unique(m_Moving.begin(), m_Moving.end()), m_Moving.end());
+        }
+
+        // task(body, transform, parent world) for moving entities still alive
+        template <typename Task>
+        EMPY_INLINE void ForEachMoving(Task&& task)
+        {
+            auto& scene = m_Context->Scene;
+            auto& hierarchy = *m_Context->Hierarchy;
+            m_Context->Jobs->ParallelFor(static_cast<uint32_t>(m_Moving.size()), 0u, 
+            [&] (uint32_t begin, uint32_t end)
+            {
+                for(uint32_t i = begin; i < end; i++)
+                {
+                    auto entity = m_Moving[i];
+                    if(!scene.valid(entity) || !scene.all_of<RigidBodyComponent, TransformComponent>(entity)) 
+                    { 
+                        continue; 
+                    }
+
+                    auto& body = scene.get<RigidBodyComponent>(entity).RigidBody;
+                    if(!body.Actor) { continue; }
+                    task(body, scene.get<TransformComponent>(entity).Transform, hierarchy.ParentWorld(entity));
+                }
+            });
+        }
+
+        // samples each skeletal model once per frame
+        EMPY_INLINE void UpdateAnimations()
+        {
+            m_Animated.clear();
+            for(auto& [uid, asset] : m_Context->Assets->GetMap<ModelAsset>())
+            {
+                auto model = static_cast<ModelAsset*>(asset.get());
+                if(model->HasJoints && model->Data)
+                {
+                    m_Animated.push_back(model->Data.get());
+                }
+            }
+
+            // one model per job, joints are independent
+            m_Context->Jobs->ParallelFor(static_cast<uint32_t>(m_Animated.size()), 1u, 
+            [this] (uint32_t begin, uint32_t end)
+            {
+                for(uint32_t i = begin; i < end; i++)
+                {
+                    m_Animated[i]->Animate(m_Context->DeltaTime);
+                }
+            });
+        }
+
+        // copies lights for the render stage
+        EMPY_INLINE void GatherLights()
+        {
+            m_Lights.Direct.clear();
+            m_Lights.Point.clear();
+            m_Lights.Spot.clear();
+
+            EnttView<Entity, DirectLightComponent>([this] (auto entity, auto& comp) 
+            {      
+                m_Lights.Direct.emplace_back(comp.Light, WorldTransform(entity));
+            }); 
+
+            EnttView<Entity, PointLightComponent>([this] (auto entity, auto& comp) 
+            {      
+                m_Lights.Point.emplace_back(comp.Light, WorldTransform(entity));
+            }); 
+
+            EnttView<Entity, SpotLightComponent>([this] (auto entity, auto& comp) 
+            {      
+                m_Lights.Spot.emplace_back(comp.Light, WorldTransform(entity));
+            }); 
+        }
+
+        // transform moved into world space by the parent's world matrix,
+        // light directions kept in rotation turn with the parent
+        EMPY_INLINE Transform3D WorldTransform(Entity& entity) const
+        {
+            auto transform = entity.template Get<TransformComponent>().Transform;
+            auto parent = m_Context->Hierarchy->ParentWorld(entity.ID());
+            if(!parent) { return transform; }
+
+            auto scale = glm::vec3(glm::length(glm::vec3((*parent)[0])), 
+                glm::length(glm::vec3((*parent)[1])), glm::length(glm::vec3((*parent)[2])));
+            auto axes = glm::max(scale, glm::vec3(1e-6f));
+            auto basis = glm::mat3(glm::vec3((*parent)[0]) / axes.x, 
+                glm::vec3((*parent)[1]) / axes.y, glm::vec3((*parent)[2]) / axes.z);
+
+            auto rotation = glm::quat_cast(basis) * transform.Quaternion();
+            transform.Translate = glm::vec3(*parent * glm::vec4(transform.Translate, 1.0f));
+            transform.Rotation = basis * transform.Rotation;
+            transform.Scale *= scale;
+            transform.SetQuaternion(rotation);
+            return transform;
         }
 
         // renders depth map, color, etc.
         EMPY_INLINE void RenderScene()
         {
+            EMPY_PROFILE_SCOPE("RenderScene");
+
+            // set shader camera, batches sort by view depth
+            EnttView<Entity, CameraComponent>([this] (auto entity, auto& comp) 
+            {      
+                auto transform = WorldTransform(entity);
+                m_Context->Renderer->SetCamera(comp.Camera, transform);
+            });
+
+            // asset lookups run on workers, each thread fills its own list
+            m_Submits.resize(m_Context->Jobs->WorkerCount() + 1u);
+            ParallelEnttView<ModelComponent, WorldMatrixComponent>([this] (auto entity, auto& comp, auto& world) 
+            {      
+                auto& material = m_Context->Assets->Get<MaterialAsset>(comp.Material);
+                auto& model = m_Context->Assets->Get<ModelAsset>(comp.Model);
+                m_Submits[JobSystem::ThreadIndex()].push_back({ &model.Data, &material.Data, world.Matrix });
+            });
+
+            // group models into instanced batches shared by all passes
+            for(auto& submits : m_Submits)
+            {
+                for(auto& submit : submits) { m_Context->Renderer->Submit(*submit.Model, *submit.Mtl, submit.World); }
+                submits.clear();
+            }
+            m_Context->Renderer->BuildBatches(*m_Context->Jobs);
+
             // ----------------------------- SHADWO MAP -------------------------------------
 
-            EnttView<Entity, DirectLightComponent>([this] (auto light, auto&) 
+            for(auto& [light, transform] : m_Lights.Direct)
             {
+                EMPY_PROFILE_SCOPE("ShadowPass");
+
                 // light direction
-                auto& lightDir = light.template Get<TransformComponent>().Transform.Rotation;
+                auto& lightDir = transform.Rotation;
                
                 // begin rendering
                 m_Context->Renderer->BeginShadowPass(lightDir);
 
                 // render depth 
-                EnttView<Entity, ModelComponent>([this, &lightDir] (auto entity, auto& comp) 
-                {    
-                    auto& transform = entity.template Get<TransformComponent>().Transform;
-                    auto& model = m_Context->Assets->Get<ModelAsset>(comp.Model);
-                    m_Context->Renderer->DrawDepth(model.Data, transform);                                     
-                }); 
+                m_Context->Renderer->DrawDepthBatches();
 
                 // ffinalize frame
                 m_Context->Renderer->EndShadowPass();
-            });
+            }
 
             // ------------------------ RENDER TO FBO --------------------------------------
 
             // start new frame
             m_Context->Renderer->NewFrame(); 
                                 
-            // set shader camera
-            EnttView<Entity, CameraComponent>([this] (auto entity, auto& comp) 
-            {      
-                auto& transform = entity.template Get<TransformComponent>().Transform;
-                m_Context->Renderer->SetCamera(comp.Camera, transform);
-            });
-            
-            // set shader point lights
-            int32_t lightCounter = 0u;
-            EnttView<Entity, PointLightComponent>([this, &lightCounter] (auto entity, auto& comp) 
-            {      
-                auto& transform = entity.template Get<TransformComponent>().Transform;
-                m_Context->Renderer->SetPointLight(comp.Light, transform, lightCounter);
-                lightCounter++;
-            }); 
-            // set number of point lights
-            m_Context->Renderer->SetPointLightCount(lightCounter);
+            // bin point and spot lights into clusters
+            m_Context->Renderer->SetLights(m_Lights.Point, m_Lights.Spot, *m_Context->Jobs);
 
             // set shader direct. lights
-            lightCounter = 0;
-            EnttView<Entity, DirectLightComponent>([this, &lightCounter] (auto entity, auto& comp) 
-            {      
-                auto& transform = entity.template Get<TransformComponent>().Transform;
-                m_Context->Renderer->SetDirectLight(comp.Light, transform, lightCounter);
+            int32_t lightCounter = 0;
+            for(auto& [light, transform] : m_Lights.Direct)
+            {
+                m_Context->Renderer->SetDirectLight(light, transform, lightCounter);
                 lightCounter++;            
-            }); 
+            }
             // set number of direct lights
             m_Context->Renderer->SetDirectLightCount(lightCounter);
 
-            // set shader spot lights
-            lightCounter = 0;
-            EnttView<Entity, SpotLightComponent>([this, &lightCounter] (auto entity, auto& comp) 
-            {      
-                auto& transform = entity.template Get<TransformComponent>().Transform;
-                m_Context->Renderer->SetSpotLight(comp.Light, transform, lightCounter);
-                lightCounter++;
-            }); 
-            // set number of spot lights
-            m_Context->Renderer->SetSpotLightCount(lightCounter);
-
             // render models
-            EnttView<Entity, ModelComponent>([this] (auto entity, auto& comp) 
-            {      
-                // retrieve assets
-                auto& transform = entity.template Get<TransformComponent>().Transform;
-                auto& material = m_Context->Assets->Get<MaterialAsset>(comp.Material);
-                auto& model = m_Context->Assets->Get<ModelAsset>(comp.Model);
-
-                // render model
-                m_Context->Renderer->Animate(model.Data, m_Context->DeltaTime);
-                m_Context->Renderer->Draw(model.Data, material.Data, transform); 
-            });  
+            m_Context->Renderer->DrawBatches();
 
             // render skybox
             EnttView<Entity, SkyboxComponent>([this] (auto entity, auto& comp) 
@@ -352,12 +715,14 @@ namespace Empy
             //CreateEntities();
 
             // deserialize scene 
-            m_Context->Serializer->Deserialize(*m_Context->Assets, "Resources/Projects/assets.yaml");
-            m_Context->Serializer->Deserialize(m_Context->Scene, "Resources/Projects/scene.yaml");
+            auto& config = m_Context->Config;
+            m_Context->Serializer->Deserialize(*m_Context->Assets, config.Assets);
+            m_Context->Serializer->Deserialize(m_Context->Scene, config.Scene);
 
             // generate enviroment maps
             EnttView<Entity, SkyboxComponent>([this] (auto entity, auto& comp) 
             {      
+                if(!m_Context->Renderer) { return; }
                 auto& skybox = m_Context->Assets->Get<SkyboxAsset>(comp.Skybox);                        
                 m_Context->Renderer->InitSkybox(skybox.Data, skybox.EnvMap, skybox.Size);                
             });          
@@ -368,13 +733,33 @@ namespace Empy
                 auto& script = m_Context->Assets->Get<ScriptAsset>(comp.Script);                        
                 auto name = m_Context->Scripts->LoadScript(script.Source);
                 m_Context->Scripts->AttachScript(entity, name);
-            });
 
-            // create rigid bodies
-            EnttView<Entity, RigidBodyComponent>([this] (auto entity, auto& comp) 
-            { 
-                m_Context->Physics->AddRigidBody(entity);               
+                // contacts are buffered for listeners only
+                if(!comp.Instance || !comp.Instance->HasCollision())
+                {
+                    m_Context->Physics->Subscribe(entity, false);
+                }
             });
+
+            // world matrices place parented bodies
+            m_Context->Hierarchy->Update();
+
+            // cooked actors from the last run, stale once any input changes
+            auto& physics = *m_Context->Physics;
+            auto snapshot = std::filesystem::path(config.Scene).replace_extension(".pxb").string();
+            auto key = physics.SnapshotKey({ config.Scene, config.Assets });
+            bool loaded = physics.LoadSnapshot(snapshot, key);
+
+            // create rigid bodies not in the snapshot
+            physics.AddRigidBodies();
+            if(!loaded) { physics.SaveSnapshot(snapshot, key); }
         }
+
+    private:
+        std::vector<EntityID> m_Moving;
+        std::vector<std::vector<ModelSubmit>> m_Submits;
+        std::vector<Model*> m_Animated;
+        SceneLights m_Lights;
+        uint32_t m_Contacts = 0u;
     };
 }
\ No newline at end of file
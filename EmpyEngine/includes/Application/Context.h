@@ -3,43 +3,131 @@
 #include "Physics/Context.h"
 #include "Graphics/Renderer.h"
 #include "Auxiliaries/Serializer.h"
+#include "Auxiliaries/Commands.h"
+#include "Auxiliaries/Hierarchy.h"
+#include "Common/Hitch.h"
+#include "Scheduler.h"
 
 namespace Empy
 {
     // forward declaration
     struct AppInterface;    
 
+    // startup options
+    struct AppConfig
+    {
+        std::string Assets = "Resources/Projects/assets.yaml";
+        std::string Scene = "Resources/Projects/scene.yaml";
+        int32_t Width = 1280;
+        int32_t Height = 720;
+
+        // no window and renderer, fixed ticks
+        bool Headless = false;
+        // headless tick count, zero runs forever
+        uint32_t Ticks = 0u;
+        double TickRate = 60.0;
+        // sleep to keep ticks at wall clock rate
+        bool Realtime = false;
+
+        // job system workers, zero uses all cores but the main thread
+        uint32_t Workers = 0u;
+        // pins workers to cores [1, n], main thread keeps core 0
+        bool PinWorkers = false;
+
+        // frames kept for hitch captures, zero disables
+        uint32_t HitchFrames = 120u;
+        // hitch above factor x median frame time
+        double HitchFactor = 2.0;
+        // fixed hitch budget in ms, overrides the factor
+        double HitchBudget = 0.0;
+
+        // input log written while running
+        std::string Record;
+        // input log fed back instead of live input and time
+        std::string Replay;
+        // RandomU64() seed, zero picks one (stored in recordings)
+        uint64_t Seed = 0u;
+    };
+
     // application context
     struct AppContext
     {
-        EMPY_INLINE AppContext()
+        EMPY_INLINE AppContext(const AppConfig& config = AppConfig()):
+            Config(config)
         {
-            Window = std::make_unique<AppWindow>(&Dispatcher, 1280, 720, "Empy Engine");
-            Scripts = std::make_unique<ScriptContext>(&Scene, Window.get());
-            Renderer = std::make_unique<GraphicsRenderer>(1280, 720);
+            if(Config.Headless)
+            {
+                Window = std::make_unique<AppWindow>(&Dispatcher);
+            }
+            else
+            {
+                Window = std::make_unique<AppWindow>(&Dispatcher, Config.Width, Config.Height, "Empy Engine");
+            }
+
+            // replays reuse the recorded seed
+            auto& log = Window->Log();
+            if(!Config.Replay.empty() && log.Replay(Config.Replay)) 
+            { 
+                Config.Seed = log.Seed(); 
+            }
+            if(!Config.Record.empty())
+            {
+                if(Config.Seed == 0u) { Config.Seed = std::random_device{}() | 1u; }
+                log.Record(Config.Record, Config.Seed);
+            }
+            if(Config.Seed != 0u) { SeedRandom(Config.Seed); }
+
+            Scheduler = std::make_unique<FrameScheduler>();
+            Hitches = std::make_unique<HitchRecorder>(Config.HitchFrames, Config.HitchFactor);
+            Hitches->SetEnabled(Config.HitchFrames > 0u);
+            Hitches->SetBudget(Config.HitchBudget);
+            Jobs = std::make_unique<JobSystem>(Config.Workers, Config.PinWorkers);
+            Commands = std::make_unique<CommandQueue>(Jobs->WorkerCount() + 1u);
+            Hierarchy = std::make_unique<TransformHierarchy>(&Scene);
+
+            // headless contexts keep a null renderer
+            if(!Config.Headless)
+            {
+                Renderer = std::make_unique<GraphicsRenderer>(Config.Width, Config.Height);
+            }
+
             Serializer = std::make_unique<DataSerializer>();
-            Physics = std::make_unique<PhysicsContext>();
-            Assets = std::make_unique<AssetRegistry>();
+            Assets = std::make_unique<AssetRegistry>(Config.Headless);
+            Physics = std::make_unique<PhysicsContext>(&Scene, Assets.get(), Jobs.get());
+            Scripts = std::make_unique<ScriptContext>(&Scene, Window.get(), &Physics->Queries());
             DeltaTime = 0.0;
         }
 
         EMPY_INLINE ~AppContext()
         {
+            // running step must finish while the scene still exists
+            if(Physics) { Physics->FetchResults(); }
+
             for(auto layer : Layers)
             {
                 EMPY_DELETE(layer);
             } 
+
+            // gl objects go while the window keeps glfw alive
+            Renderer.reset();
         }
         
+        // declared first, outlives its users
+        std::unique_ptr<JobSystem> Jobs;
+        std::unique_ptr<TransformHierarchy> Hierarchy;
         std::unique_ptr<GraphicsRenderer> Renderer;
         std::unique_ptr<DataSerializer> Serializer;
+        std::unique_ptr<FrameScheduler> Scheduler;
         std::unique_ptr<PhysicsContext> Physics;
+        std::unique_ptr<CommandQueue> Commands;
         std::unique_ptr<ScriptContext> Scripts;
         std::unique_ptr<AssetRegistry> Assets;
+        std::unique_ptr<HitchRecorder> Hitches;
         std::vector<AppInterface*> Layers;
         std::unique_ptr<AppWindow> Window;
         EventDispatcher Dispatcher;
         EntityRegistry Scene;
+        AppConfig Config;
         double DeltaTime;
     };
 }
\ No newline at end of file
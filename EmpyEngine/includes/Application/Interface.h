@@ -3,6 +3,9 @@
 
 namespace Empy
 {
+    // bytes of components per parallel view chunk
+    constexpr uint32_t PARALLEL_CHUNK_BYTES = 32u * 1024u;
+
     struct AppInterface
     {
         EMPY_INLINE virtual ~AppInterface() = default;
@@ -35,6 +38,43 @@ namespace Empy
             });
         }
 
+        // parent entity to another, NENTT detaches
+        EMPY_INLINE void SetParent(EntityID child, EntityID parent) 
+        { 
+            m_Context->Hierarchy->SetParent(child, parent);
+        }
+
+        // loop through entities in chunks on job threads, task(DeferredEntity, Comps&...)
+        template<typename... Comps, typename Task>
+        EMPY_INLINE void ParallelEnttView(Task&& task, uint32_t chunk = 0u) 
+        {
+            auto view = m_Context->Scene.view<Comps...>();
+            auto pool = view.handle();
+            if(pool == nullptr) { return; }
+
+            // fit chunk components in l1 cache
+            if(chunk == 0u)
+            {
+                constexpr uint32_t stride = (sizeof(EntityID) + ... + sizeof(Comps));
+                chunk = std::max(64u, PARALLEL_CHUNK_BYTES / stride);
+            }
+
+            auto entities = pool->data();
+            auto& commands = *m_Context->Commands;
+            m_Context->Jobs->ParallelFor(static_cast<uint32_t>(pool->size()), chunk, 
+            [&] (uint32_t begin, uint32_t end)
+            {
+                auto& buffer = commands.Local();
+                for(uint32_t i = begin; i < end; i++)
+                {
+                    // leading pool may hold entities missing other components
+                    auto entity = entities[i];
+                    if(!view.contains(entity)) { continue; }
+                    task(DeferredEntity(entity, buffer), view.template get<Comps>(entity)...);
+                }
+            });
+        }
+
         // loop through entities
         template<typename Task>
         EMPY_INLINE void AssetView(Task&& task) 
@@ -147,7 +187,28 @@ namespace Empy
 
         EMPY_INLINE uint32_t GetSceneFrame() 
         {
-            return m_Context->Renderer->GetFrame();
+            return m_Context->Renderer ? m_Context->Renderer->GetFrame() : 0u;
+        }
+
+        // loop through frame stages (name, timing)
+        template<typename Task>
+        EMPY_INLINE void StageView(Task&& task) 
+        {
+            m_Context->Scheduler->View([&] (auto& stage) { task(stage); });
+        }
+
+        // loop through profiled scopes of last frame (name, calls, time)
+        template<typename Task>
+        EMPY_INLINE void ProfileView(Task&& task) 
+        {
+            for(auto& stat : Profiler::Get().Frame()) { task(stat); }
+        }
+
+        // runs frame stages and jobs on the main thread
+        EMPY_INLINE void SetSerialFrame(bool serial) 
+        {
+            m_Context->Scheduler->SetSerial(serial);
+            m_Context->Jobs->SetSerial(serial);
         }
 
     protected:
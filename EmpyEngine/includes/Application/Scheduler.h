@@ -0,0 +1,295 @@
+#pragma once
+#include "Common/Profiler.h"
+#include "Common/Jobs.h"
+
+namespace Empy
+{
+    // stage of the frame task graph
+    struct FrameStage
+    {
+        EMPY_INLINE FrameStage(const std::string& name, JobFunction&& task):
+            Name(name), Task(std::move(task))
+        {}
+
+        // declares components read by stage
+        template <typename... Types>
+        EMPY_INLINE FrameStage& Read()
+        {
+            (Reads.push_back(TypeID<Types>()), ...);
+            (Storages.push_back([] (EntityRegistry& r) { r.storage<Types>(); }), ...);
+            return *this;
+        }
+
+        // declares components written by stage
+        template <typename... Types>
+        EMPY_INLINE FrameStage& Write()
+        {
+            (Writes.push_back(TypeID<Types>()), ...);
+            (Storages.push_back([] (EntityRegistry& r) { r.storage<Types>(); }), ...);
+            return *this;
+        }
+
+        // stage waits for another stage to finish
+        EMPY_INLINE FrameStage& After(const std::string& stage)
+        {
+            Predecessors.push_back(stage);
+            return *this;
+        }
+
+        // runs stage on the thread calling Run()
+        EMPY_INLINE FrameStage& MainThread()
+        {
+            OnMainThread = true;
+            return *this;
+        }
+
+        // stage conflicts with every other stage
+        EMPY_INLINE FrameStage& Exclusive()
+        {
+            IsExclusive = true;
+            return *this;
+        }
+
+        std::string Name;
+        JobFunction Task;
+        std::vector<uint32_t> Reads;
+        std::vector<uint32_t> Writes;
+        bool OnMainThread = false;
+        bool IsExclusive = false;
+        // last frame duration (ms)
+        double Time = 0.0;
+
+    private:
+        EMPY_INLINE bool Conflicts(const FrameStage& other) const
+        {
+            if(IsExclusive || other.IsExclusive) { return true; }
+            if(std::count(other.Predecessors.begin(), other.Predecessors.end(), Name)) { return true; }
+            auto overlap = [] (auto& a, auto& b)
+            {
+                return std::find_first_of(a.begin(), a.end(), b.begin(), b.end()) != a.end();
+            };
+            return overlap(Writes, other.Writes) ||
+                overlap(Writes, other.Reads) ||
+                overlap(Reads, other.Writes);
+        }
+
+    private:
+        std::vector<std::function<void(EntityRegistry&)>> Storages;
+        std::vector<std::string> Predecessors;
+        std::atomic<uint32_t> Remaining = 0u;
+        std::vector<uint32_t> Dependents;
+        uint32_t Dependencies = 0u;
+        friend struct FrameScheduler;
+    };
+
+    // runs frame stages as a dependency graph
+    struct FrameScheduler
+    {
+        EMPY_INLINE FrameStage& AddStage(const std::string& name, JobFunction&& task)
+        {
+            m_Stages.push_back(std::make_unique<FrameStage>(name, std::move(task)));
+            m_Compiled = false;
+            return *m_Stages.back();
+        }
+
+        // executes all stages, blocks until done
+        EMPY_INLINE void Run(JobSystem& jobs, EntityRegistry& registry)
+        {
+            if(!m_Compiled) { Compile(registry); }
+
+            // debug: sorted order on this thread
+            if(m_Serial)
+            {
+                for(auto& stage : m_Stages) { Execute(*stage); }
+                return;
+            }
+
+            // reset dependency counters
+            m_Completed.store(0u, std::memory_order_relaxed);
+            for(auto& stage : m_Stages)
+            {
+                stage->Remaining.store(stage->Dependencies, std::memory_order_relaxed);
+            }
+
+            // kick root stages
+            for(uint32_t i = 0u; i < m_Stages.size(); i++)
+            {
+                if(m_Stages[i]->Dependencies == 0u) { Schedule(jobs, i); }
+            }
+
+            // run main thread stages, help workers otherwise
+            const uint32_t count = static_cast<uint32_t>(m_Stages.size());
+            while(m_Completed.load(std::memory_order_acquire) < count)
+            {
+                if(auto index = PopMainThread(); index < count)
+                {
+                    Complete(jobs, index);
+                }
+                else if(!jobs.Help())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // forces stages to run one after another
+        EMPY_INLINE void SetSerial(bool serial)
+        {
+            m_Serial = serial;
+        }
+
+        EMPY_INLINE bool IsSerial() const
+        {
+            return m_Serial;
+        }
+
+        // loop through stages
+        template <typename Task>
+        EMPY_INLINE void View(Task&& task)
+        {
+            for(auto& stage : m_Stages) { task(*stage); }
+        }
+
+    private:
+        // orders stages after their named predecessors, registration order otherwise
+        EMPY_INLINE void SortStages()
+        {
+            std::unordered_map<std::string, uint32_t> names;
+            for(uint32_t i = 0u; i < m_Stages.size(); i++) { names[m_Stages[i]->Name] = i; }
+
+            std::vector<std::vector<uint32_t>> before(m_Stages.size());
+            for(uint32_t i = 0u; i < m_Stages.size(); i++)
+            {
+                for(auto& name : m_Stages[i]->Predecessors)
+                {
+                    auto it = names.find(name);
+                    if(it == names.end())
+                    {
+                        EMPY_ERROR("stage '{}' waits for unknown stage '{}'!", m_Stages[i]->Name, name);
+                        continue;
+                    }
+                    before[i].push_back(it->second);
+                }
+            }
+
+            // earliest registered ready stage goes first
+            std::vector<bool> placed(m_Stages.size(), false);
+            std::vector<std::unique_ptr<FrameStage>> sorted;
+            while(sorted.size() < m_Stages.size())
+            {
+                uint32_t next = UINT32_MAX;
+                for(uint32_t i = 0u; i < m_Stages.size() && next == UINT32_MAX; i++)
+                {
+                    if(placed[i]) { continue; }
+                    auto ready = std::all_of(before[i].begin(), before[i].end(), [&placed] (uint32_t p) { return placed[p]; });
+                    if(ready) { next = i; }
+                }
+
+                // cycle, keep the rest in registration order
+                if(next == UINT32_MAX)
+                {
+                    for(uint32_t i = 0u; i < m_Stages.size(); i++)
+                    {
+                        if(placed[i]) { continue; }
+                        EMPY_ERROR("stage '{}' is part of a dependency cycle!", m_Stages[i]->Name);
+                        sorted.push_back(std::move(m_Stages[i]));
+                        placed[i] = true;
+                    }
+                    break;
+                }
+                sorted.push_back(std::move(m_Stages[next]));
+                placed[next] = true;
+            }
+            m_Stages = std::move(sorted);
+        }
+
+        // builds dependency edges in sorted order
+        EMPY_INLINE void Compile(EntityRegistry& registry)
+        {
+            SortStages();
+            int32_t lastMain = -1;
+
+            for(uint32_t i = 0u; i < m_Stages.size(); i++)
+            {
+                auto& stage = *m_Stages[i];
+                stage.Dependents.clear();
+                stage.Dependencies = 0u;
+
+                // make sure pools exist before views run concurrently
+                for(auto& storage : stage.Storages) { storage(registry); }
+            }
+
+            for(uint32_t j = 0u; j < m_Stages.size(); j++)
+            {
+                auto& stage = *m_Stages[j];
+
+                for(uint32_t i = 0u; i < j; i++)
+                {
+                    // main thread stages keep their order
+                    bool ordered = (stage.OnMainThread && (int32_t)i == lastMain);
+                    if(ordered || m_Stages[i]->Conflicts(stage))
+                    {
+                        m_Stages[i]->Dependents.push_back(j);
+                        stage.Dependencies++;
+                    }
+                }
+
+                if(stage.OnMainThread) { lastMain = j; }
+            }
+            m_Compiled = true;
+        }
+
+        EMPY_INLINE void Schedule(JobSystem& jobs, uint32_t index)
+        {
+            if(m_Stages[index]->OnMainThread)
+            {
+                std::lock_guard<std::mutex> lock(m_MainMutex);
+                m_MainQueue.push_back(index);
+                return;
+            }
+            jobs.Submit([this, &jobs, index] { Complete(jobs, index); });
+        }
+
+        EMPY_INLINE void Complete(JobSystem& jobs, uint32_t index)
+        {
+            auto& stage = *m_Stages[index];
+            Execute(stage);
+
+            for(auto dependent : stage.Dependents)
+            {
+                auto& remaining = m_Stages[dependent]->Remaining;
+                if(remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+                {
+                    Schedule(jobs, dependent);
+                }
+            }
+            m_Completed.fetch_add(1u, std::memory_order_release);
+        }
+
+        EMPY_INLINE void Execute(FrameStage& stage)
+        {
+            EMPY_PROFILE_SCOPE(stage.Name.c_str());
+            auto start = std::chrono::high_resolution_clock::now();
+            stage.Task();
+            auto end = std::chrono::high_resolution_clock::now();
+            stage.Time = std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        EMPY_INLINE uint32_t PopMainThread()
+        {
+            std::lock_guard<std::mutex> lock(m_MainMutex);
+            if(m_MainQueue.empty()) { return UINT32_MAX; }
+            auto index = m_MainQueue.front();
+            m_MainQueue.pop_front();
+            return index;
+        }
+
+    private:
+        std::vector<std::unique_ptr<FrameStage>> m_Stages;
+        std::atomic<uint32_t> m_Completed = 0u;
+        std::deque<uint32_t> m_MainQueue;
+        std::mutex m_MainMutex;
+        bool m_Compiled = false;
+        bool m_Serial = false;
+    };
+}
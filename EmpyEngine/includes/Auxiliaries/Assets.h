@@ -89,7 +89,9 @@ namespace Empy
     // asset registry to manage the addition and retrieval of assets
     struct AssetRegistry
     {
-        EMPY_INLINE AssetRegistry()
+        // headless registries keep cpu side data only
+        EMPY_INLINE AssetRegistry(bool headless = false):
+            m_Headless(headless)
         {
             // add default asset for each type
             AddEmpty<MaterialAsset>();
@@ -102,8 +104,9 @@ namespace Empy
 
         EMPY_INLINE auto AddSkybox(AssetID uid, const std::string& source, int32_t size, bool isHDR = true, bool flipV = true)
         {
+            EMPY_PROFILE_SCOPE("Assets::LoadSkybox");
             auto asset = std::make_shared<SkyboxAsset>();
-            asset->EnvMap.Load(source, isHDR, flipV);
+            if(!m_Headless) { asset->EnvMap.Load(source, isHDR, flipV); }
             asset->Type = AssetType::SKYBOX;
             asset->IsHDR = isHDR;
             asset->FlipV = flipV;
@@ -114,8 +117,9 @@ namespace Empy
        
         EMPY_INLINE auto AddTexture(AssetID uid, const std::string& source, bool isHDR = false, bool flipV = true)
         {
+            EMPY_PROFILE_SCOPE("Assets::LoadTexture");
             auto asset = std::make_shared<TextureAsset>();
-            asset->Data.Load(source, isHDR, flipV);
+            if(!m_Headless) { asset->Data.Load(source, isHDR, flipV); }
             asset->Type = AssetType::TEXTURE;
             asset->FlipV = flipV;
             asset->IsHDR = isHDR;
@@ -125,15 +129,16 @@ namespace Empy
 
         EMPY_INLINE auto AddModel(AssetID uid, const std::string& source, bool hasJoints = false)
         {
+            EMPY_PROFILE_SCOPE("Assets::LoadModel");
             auto asset = std::make_shared<ModelAsset>();
             asset->HasJoints = hasJoints;
             asset->Type = AssetType::MODEL;
 
             // load model
             if(hasJoints)
-                asset->Data = std::make_shared<SkeletalModel>(source);
+                asset->Data = std::make_shared<SkeletalModel>(source, m_Headless);
             else
-                asset->Data = std::make_shared<StaticModel>(source);
+                asset->Data = std::make_shared<StaticModel>(source, m_Headless);
 
             Add(uid, source, asset);
             return asset;
@@ -201,6 +206,11 @@ namespace Empy
             m_Registry.clear();
         }
 
+        EMPY_INLINE bool IsHeadless() const
+        {
+            return m_Headless;
+        }
+
     private:
         // adds a new asset to the registry
         template <typename T>
@@ -225,5 +235,6 @@ namespace Empy
 
     private:
         std::unordered_map<uint32_t, AssetMap> m_Registry;  
+        bool m_Headless = false;
     };
 }
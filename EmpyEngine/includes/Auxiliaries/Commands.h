@@ -0,0 +1,131 @@
+#pragma once
+#include "ECS.h"
+#include "Common/Jobs.h"
+
+namespace Empy
+{
+    // deferred structural change
+    using EnttCommand = std::function<void(EntityRegistry&)>;
+
+    // registry changes recorded by one thread
+    struct CommandBuffer
+    {
+        // creates entity at flush, init(Entity&)
+        template<typename Task>
+        EMPY_INLINE void Create(Task&& init)
+        {
+            Commands.push_back([init = std::forward<Task>(init)] (EntityRegistry& registry) mutable
+            {
+                Entity entity(&registry);
+                init(entity);
+            });
+        }
+
+        EMPY_INLINE void Destroy(EntityID entity)
+        {
+            Commands.push_back([entity] (EntityRegistry& registry)
+            {
+                if(registry.valid(entity)) { registry.destroy(entity); }
+            });
+        }
+
+        template<typename T, typename... Args>
+        EMPY_INLINE void Attach(EntityID entity, Args&&... args)
+        {
+            Commands.push_back([entity, comp = T(std::forward<Args>(args)...)]
+            (EntityRegistry& registry) mutable
+            {
+                if(registry.valid(entity))
+                {
+                    registry.emplace_or_replace<T>(entity, std::move(comp));
+                }
+            });
+        }
+
+        template<typename T>
+        EMPY_INLINE void Detach(EntityID entity)
+        {
+            Commands.push_back([entity] (EntityRegistry& registry)
+            {
+                if(registry.valid(entity)) { registry.remove<T>(entity); }
+            });
+        }
+
+        std::vector<EnttCommand> Commands;
+    };
+
+    // entity handle restricted to deferred changes
+    struct DeferredEntity
+    {
+        EMPY_INLINE DeferredEntity(EntityID entity, CommandBuffer& buffer):
+            m_Buffer(buffer), m_EnttID(entity)
+        {}
+
+        EMPY_INLINE operator EntityID ()
+        {
+            return m_EnttID;
+        }
+
+        EMPY_INLINE EntityID ID()
+        {
+            return m_EnttID;
+        }
+
+        template<typename T, typename... Args>
+        EMPY_INLINE void Attach(Args&&... args)
+        {
+            m_Buffer.Attach<T>(m_EnttID, std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        EMPY_INLINE void Detach()
+        {
+            m_Buffer.Detach<T>(m_EnttID);
+        }
+
+        EMPY_INLINE void Destroy()
+        {
+            m_Buffer.Destroy(m_EnttID);
+        }
+
+        template<typename Task>
+        EMPY_INLINE void Create(Task&& init)
+        {
+            m_Buffer.Create(std::forward<Task>(init));
+        }
+
+    private:
+        CommandBuffer& m_Buffer;
+        EntityID m_EnttID;
+    };
+
+    // one command buffer per job thread
+    struct CommandQueue
+    {
+        EMPY_INLINE CommandQueue(uint32_t threads):
+            m_Buffers(threads)
+        {}
+
+        // buffer owned by calling thread
+        EMPY_INLINE CommandBuffer& Local()
+        {
+            return m_Buffers[JobSystem::ThreadIndex()];
+        }
+
+        // applies recorded changes, call at sync points only
+        EMPY_INLINE void Flush(EntityRegistry& registry)
+        {
+            for(auto& buffer : m_Buffers)
+            {
+                for(auto& command : buffer.Commands)
+                {
+                    command(registry);
+                }
+                buffer.Commands.clear();
+            }
+        }
+
+    private:
+        std::vector<CommandBuffer> m_Buffers;
+    };
+}
@@ -35,6 +35,14 @@ namespace Empy
         Transform3D Transform;
     }; 
     
+    // world matrix component
+    struct WorldMatrixComponent 
+    {
+        EMPY_INLINE WorldMatrixComponent(const WorldMatrixComponent&) = default;
+        EMPY_INLINE WorldMatrixComponent() = default; 
+        glm::mat4 Matrix = glm::mat4(1.0f);
+    }; 
+    
     // rigid body component
     struct RigidBodyComponent 
     {
@@ -0,0 +1,176 @@
+#pragma once
+#include "ECS.h"
+#include <unordered_set>
+
+namespace Empy
+{
+    // parent/child transforms in topological order
+    struct TransformHierarchy
+    {
+        EMPY_INLINE TransformHierarchy(EntityRegistry* registry):
+            m_Registry(registry)
+        {
+            // structural changes invalidate the node order
+            m_Registry->on_construct<InfoComponent>().connect<&TransformHierarchy::OnChange>(*this);
+            m_Registry->on_update<InfoComponent>().connect<&TransformHierarchy::OnChange>(*this);
+            m_Registry->on_destroy<InfoComponent>().connect<&TransformHierarchy::OnChange>(*this);
+            m_Registry->on_construct<TransformComponent>().connect<&TransformHierarchy::OnChange>(*this);
+            m_Registry->on_destroy<TransformComponent>().connect<&TransformHierarchy::OnChange>(*this);
+            m_Registry->on_destroy<WorldMatrixComponent>().connect<&TransformHierarchy::OnChange>(*this);
+        }
+
+        // sets child's parent, NENTT detaches
+        EMPY_INLINE void SetParent(EntityID child, EntityID parent)
+        {
+            auto& info = m_Registry->get_or_emplace<InfoComponent>(child);
+            info.Parent = EMPTY_ASSET;
+
+            if(parent != NENTT && m_Registry->all_of<InfoComponent>(parent))
+            {
+                info.Parent = m_Registry->get<InfoComponent>(parent).UID;
+            }
+            m_Invalid = true;
+        }
+
+        // world matrix of entity's parent as of the last update, null for roots
+        EMPY_INLINE const glm::mat4* ParentWorld(EntityID entity) const
+        {
+            auto itr = m_Parents.find(entity);
+            if(itr == m_Parents.end() || !m_Registry->valid(itr->second)) { return nullptr; }
+            auto world = m_Registry->try_get<WorldMatrixComponent>(itr->second);
+            return world ? &world->Matrix : nullptr;
+        }
+
+        // forces a rebuild on next update
+        EMPY_INLINE void Invalidate()
+        {
+            m_Invalid = true;
+        }
+
+        // recomputes world matrices of changed subtrees
+        EMPY_INLINE void Update()
+        {
+            bool rebuilt = m_Invalid;
+            if(rebuilt) { Rebuild(); }
+
+            for(auto& node : m_Nodes)
+            {
+                // parent moved or local transform changed
+                bool parentDirty = (node.Parent >= 0 && m_Nodes[node.Parent].Dirty);
+                node.Dirty = (rebuilt || parentDirty || !(node.Cached == *node.Local));
+                if(!node.Dirty) { continue; }
+
+                node.Cached = *node.Local;
+                *node.World = node.Cached.Matrix();
+                if(node.Parent >= 0)
+                {
+                    *node.World = *m_Nodes[node.Parent].World * *node.World;
+                }
+            }
+        }
+
+    private:
+        struct Node
+        {
+            glm::mat4* World = nullptr;
+            Transform3D* Local = nullptr;
+            Transform3D Cached;
+            int32_t Parent = -1;
+            bool Dirty = true;
+        };
+
+        EMPY_INLINE void OnChange(EntityRegistry&, EntityID)
+        {
+            m_Invalid = true;
+        }
+
+        // sorts nodes so parents precede their children
+        EMPY_INLINE void Rebuild()
+        {
+            std::unordered_map<EntityID, std::vector<EntityID>> children;
+            std::unordered_map<AssetID, EntityID> owners;
+            std::unordered_set<EntityID> pending;
+            std::vector<std::pair<EntityID, int32_t>> queue;
+            std::vector<EntityID> entities;
+
+            auto view = m_Registry->view<TransformComponent>();
+            queue.reserve(view.size());
+            m_Parents.clear();
+
+            // entities without info are always roots
+            for(auto entity : view)
+            {
+                if(m_Registry->all_of<InfoComponent>(entity))
+                {
+                    // duplicate uids resolve to the first owner
+                    owners.emplace(m_Registry->get<InfoComponent>(entity).UID, entity);
+                    entities.push_back(entity);
+                    pending.insert(entity);
+                    continue;
+                }
+                queue.emplace_back(entity, -1);
+            }
+
+            // enqueue node once, parent index in queue
+            auto visit = [&] (EntityID entity, int32_t parent)
+            {
+                if(pending.erase(entity)) { queue.emplace_back(entity, parent); }
+            };
+
+            // roots have no parent or a missing one
+            for(auto entity : entities)
+            {
+                auto uid = m_Registry->get<InfoComponent>(entity).Parent;
+                auto owner = (uid == EMPTY_ASSET) ? owners.end() : owners.find(uid);
+                if(owner == owners.end() || owner->second == entity)
+                {
+                    visit(entity, -1);
+                    continue;
+                }
+                children[owner->second].push_back(entity);
+                m_Parents[entity] = owner->second;
+            }
+
+            // breadth first, leftovers are parent cycles
+            for(size_t i = 0u; i < queue.size() || !pending.empty(); i++)
+            {
+                if(i == queue.size())
+                {
+                    EMPY_WARN("transform hierarchy contains a cycle!");
+                    m_Parents.erase(*pending.begin());
+                    visit(*pending.begin(), -1);
+                }
+
+                auto itr = children.find(queue[i].first);
+                if(itr == children.end()) { continue; }
+
+                for(auto child : itr->second)
+                {
+                    visit(child, static_cast<int32_t>(i));
+                }
+            }
+
+            // contiguous nodes, pointers resolved after all emplaces
+            m_Nodes.resize(queue.size());
+            for(auto& [entity, parent] : queue)
+            {
+                m_Registry->get_or_emplace<WorldMatrixComponent>(entity);
+            }
+
+            for(size_t i = 0u; i < queue.size(); i++)
+            {
+                auto [entity, parent] = queue[i];
+                m_Nodes[i].Local = &m_Registry->get<TransformComponent>(entity).Transform;
+                m_Nodes[i].World = &m_Registry->get<WorldMatrixComponent>(entity).Matrix;
+                m_Nodes[i].Parent = parent;
+            }
+            m_Invalid = false;
+        }
+
+    private:
+        std::unordered_map<EntityID, EntityID> m_Parents;
+        EntityRegistry* m_Registry;
+        std::vector<Node> m_Nodes;
+        bool m_Invalid = true;
+    };
+}
@@ -55,7 +55,7 @@ namespace Empy
                                 emitter << YAML::Key << "TransformComponent" << YAML::BeginMap;
                                 {
                                     emitter << YAML::Key << "Translate" << YAML::Value << transform.Translate;
-                                    emitter << YAML::Key << "Rotation" << YAML::Value << transform.Rotation;
+                                    emitter << YAML::Key << "Rotation" << YAML::Value << transform.Euler();
                                     emitter << YAML::Key << "Scale" << YAML::Value << transform.Scale;
                                 }
                                 emitter << YAML::EndMap;
@@ -84,6 +84,9 @@ namespace Empy
                                     emitter << YAML::Key << "DynamicFriction" << YAML::Value << collider.DynamicFriction;
                                     emitter << YAML::Key << "StaticFriction" << YAML::Value << collider.StaticFriction;
                                     emitter << YAML::Key << "Restitution" << YAML::Value << collider.Restitution;
+                                    emitter << YAML::Key << "Model" << YAML::Value << collider.Model;
+                                    emitter << YAML::Key << "Layer" << YAML::Value << collider.Layer;
+                                    emitter << YAML::Key << "Mask" << YAML::Value << collider.Mask;
                                     emitter << YAML::Key << "Type" << YAML::Value << type;
                                 }
                                 emitter << YAML::EndMap;
@@ -322,6 +325,10 @@ namespace Empy
                         collider.DynamicFriction = data["DynamicFriction"].as<float>();
                         collider.StaticFriction = data["StaticFriction"].as<float>();
                         collider.Restitution = data["Restitution"].as<float>();
+                        // optional mesh source
+                        if(data["Model"]) { collider.Model = data["Model"].as<AssetID>(); }
+                        if(data["Layer"]) { collider.Layer = data["Layer"].as<uint32_t>(); }
+                        if(data["Mask"]) { collider.Mask = data["Mask"].as<uint32_t>(); }
                         // get type
                         const auto name = data["Type"].as<std::string>();
                         auto type = magic_enum::enum_cast<ColliderType>(name);
@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <bitset>
+#include <array>
 #include <random>
 #include <memory>
 #include <sstream>
@@ -91,13 +92,35 @@ namespace Empy
         return static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(&typeid(T)));
     }
 
+    // shared generator, device seeded until SeedRandom()
+    EMPY_INLINE std::mt19937_64& RandomEngine() 
+    {
+        static std::mt19937_64 generator(std::random_device{}());
+        return generator;
+    }
+
+    // same seed, same RandomU64() sequence
+    EMPY_INLINE void SeedRandom(uint64_t seed) 
+    {
+        RandomEngine().seed(seed);
+    }
+
     // generate random 64 bit
     EMPY_INLINE uint64_t RandomU64() 
     {
-        static std::random_device device;
-        static std::mt19937_64 generator(device());
-        static std::uniform_int_distribution<uint64_t> distribution;
-        return distribution(generator);
+        std::uniform_int_distribution<uint64_t> distribution;
+        return distribution(RandomEngine());
+    }
+
+    // fnv-1a 64 bit, pass previous hash to chain
+    EMPY_INLINE uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) 
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0u; i < size; i++) 
+        { 
+            hash = (hash ^ bytes[i]) * 1099511628211ull; 
+        }
+        return hash;
     }
 
     // console logging
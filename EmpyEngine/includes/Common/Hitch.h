@@ -0,0 +1,205 @@
+#pragma once
+#include "Profiler.h"
+
+namespace Empy
+{
+    // one frame of the rolling window, vectors keep their capacity
+    struct FrameRecord
+    {
+        std::vector<std::pair<const char*, double>> Counters;
+        std::vector<std::pair<const char*, double>> Stages;
+        std::vector<ProfileStat> Scopes;
+        std::vector<const char*> Events;
+        uint64_t Index = 0u;
+        // milliseconds
+        double Time = 0.0;
+    };
+
+    // keeps the last frames and dumps them when one runs over budget
+    struct HitchRecorder
+    {
+        // frames of warm-up and cool-down before a dump is allowed
+        static constexpr uint32_t MIN_FRAMES = 30u;
+
+        EMPY_INLINE HitchRecorder(uint32_t frames = 120u, double factor = 2.0,
+            const std::string& directory = "Resources/Profiles/Hitches"):
+            m_Frames(std::max(frames, 2u)), m_Directory(directory), m_Factor(factor)
+        {
+            m_Times.reserve(m_Frames.size());
+        }
+
+        // frames over factor x median of the window are hitches
+        EMPY_INLINE void SetFactor(double factor)
+        {
+            m_Factor = factor;
+        }
+
+        // fixed budget in ms, zero falls back to the median factor
+        EMPY_INLINE void SetBudget(double budget)
+        {
+            m_Budget = budget;
+        }
+
+        EMPY_INLINE void SetEnabled(bool enabled)
+        {
+            m_Enabled = enabled;
+        }
+
+        EMPY_INLINE bool IsEnabled() const
+        {
+            return m_Enabled;
+        }
+
+        // name must outlive the recorder
+        EMPY_INLINE void Stage(const char* name, double time)
+        {
+            if(m_Enabled) { Current().Stages.emplace_back(name, time); }
+        }
+
+        EMPY_INLINE void Counter(const char* name, double value)
+        {
+            if(m_Enabled) { Current().Counters.emplace_back(name, value); }
+        }
+
+        // marks something that happened during the frame
+        EMPY_INLINE void Mark(const char* name)
+        {
+            if(m_Enabled) { Current().Events.push_back(name); }
+        }
+
+        // closes the frame, returns true if the window was dumped
+        EMPY_INLINE bool EndFrame()
+        {
+            auto now = Profiler::Now();
+            auto time = m_LastEnd ? (now - m_LastEnd) * 1e-6 : 0.0;
+            m_LastEnd = now;
+            if(!m_Enabled) { return false; }
+
+            auto& record = Current();
+            auto& scopes = Profiler::Get().Frame();
+            record.Scopes.assign(scopes.begin(), scopes.end());
+            record.Index = m_Index;
+            record.Time = time;
+
+            auto median = Median();
+            auto budget = Budget(median);
+            m_Index++;
+            m_Cooldown = m_Cooldown ? m_Cooldown - 1u : 0u;
+
+            bool dumped = false;
+            if(budget > 0.0 && time > budget && m_Cooldown == 0u)
+            {
+                dumped = Dump(budget, median);
+                // next window holds no frame of this dump
+                m_Cooldown = static_cast<uint32_t>(std::max<size_t>(m_Frames.size(), MIN_FRAMES));
+            }
+
+            // recycle the oldest slot for the next frame
+            auto& next = Current();
+            next.Counters.clear();
+            next.Stages.clear();
+            next.Scopes.clear();
+            next.Events.clear();
+            return dumped;
+        }
+
+    private:
+        // writes the window as json, oldest frame first
+        EMPY_INLINE bool Dump(double budget, double median)
+        {
+            std::error_code error;
+            std::filesystem::create_directories(m_Directory, error);
+
+            auto path = m_Directory + "/hitch_" + std::to_string(m_Index - 1u) + ".json";
+            std::ofstream stream(path);
+            if(!stream)
+            {
+                EMPY_ERROR("failed to write hitch capture: {}", path);
+                return false;
+            }
+
+            stream << "{\"budget\":" << budget << ",\"median\":" << median << ",\"frames\":[";
+            auto count = std::min<uint64_t>(m_Index, m_Frames.size());
+            for(auto i = m_Index - count; i < m_Index; i++)
+            {
+                auto& record = m_Frames[i % m_Frames.size()];
+                stream << (i + count == m_Index ? "" : ",") << "\n{\"index\":" << record.Index
+                    << ",\"time\":" << record.Time;
+
+                WritePairs(stream, "stages", record.Stages);
+                WritePairs(stream, "counters", record.Counters);
+
+                stream << ",\"scopes\":{";
+                for(size_t k = 0u; k < record.Scopes.size(); k++)
+                {
+                    auto& scope = record.Scopes[k];
+                    stream << (k ? "," : "") << "\"" << scope.Name << "\":["
+                        << scope.Calls << "," << scope.Time << "]";
+                }
+
+                stream << "},\"events\":[";
+                for(size_t k = 0u; k < record.Events.size(); k++)
+                {
+                    stream << (k ? "," : "") << "\"" << record.Events[k] << "\"";
+                }
+                stream << "]}";
+            }
+            stream << "\n]}\n";
+
+            EMPY_WARN("frame {} took {:.2f} ms, hitch capture: {}", m_Index - 1u,
+                m_Frames[(m_Index - 1u) % m_Frames.size()].Time, path);
+            return true;
+        }
+
+        EMPY_INLINE FrameRecord& Current()
+        {
+            return m_Frames[m_Index % m_Frames.size()];
+        }
+
+        // fixed budget or factor x median, zero while warming up
+        EMPY_INLINE double Budget(double median) const
+        {
+            if(m_Budget > 0.0) { return m_Budget; }
+            if(m_Index < MIN_FRAMES) { return 0.0; }
+            return m_Factor * median;
+        }
+
+        // median of the window, the current frame owns the oldest slot
+        EMPY_INLINE double Median()
+        {
+            m_Times.clear();
+            auto count = std::min<uint64_t>(m_Index, m_Frames.size() - 1u);
+            for(auto i = m_Index - count; i < m_Index; i++)
+            {
+                m_Times.push_back(m_Frames[i % m_Frames.size()].Time);
+            }
+            if(m_Times.empty()) { return 0.0; }
+
+            auto middle = m_Times.begin() + m_Times.size() / 2u;
+            std::nth_element(m_Times.begin(), middle, m_Times.end());
+            return *middle;
+        }
+
+        EMPY_INLINE static void WritePairs(std::ofstream& stream, const char* key,
+            const std::vector<std::pair<const char*, double>>& pairs)
+        {
+            stream << ",\"" << key << "\":{";
+            for(size_t k = 0u; k < pairs.size(); k++)
+            {
+                stream << (k ? "," : "") << "\"" << pairs[k].first << "\":" << pairs[k].second;
+            }
+            stream << "}";
+        }
+
+    private:
+        std::vector<FrameRecord> m_Frames;
+        std::vector<double> m_Times;
+        std::string m_Directory;
+        uint32_t m_Cooldown = 0u;
+        uint64_t m_LastEnd = 0u;
+        uint64_t m_Index = 0u;
+        bool m_Enabled = true;
+        double m_Budget = 0.0;
+        double m_Factor;
+    };
+}
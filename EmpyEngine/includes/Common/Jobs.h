@@ -0,0 +1,283 @@
+#pragma once
+#include "Core.h"
+#include "Sampler.h"
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+#if defined(__linux__)
+    #include <pthread.h>
+#endif
+
+namespace Empy
+{
+    // job function
+    using JobFunction = std::function<void()>;
+
+    // tracks a group of submitted jobs
+    struct JobCounter
+    {
+        EMPY_INLINE bool Done() const
+        {
+            return Pending.load(std::memory_order_acquire) == 0u;
+        }
+
+        std::atomic<uint32_t> Pending = 0u;
+    };
+
+    // work-stealing thread pool
+    struct JobSystem
+    {
+        // pinned workers run on cores [1, n], main thread keeps core 0
+        EMPY_INLINE JobSystem(uint32_t workers = 0u, bool pinThreads = false)
+        {
+            // use all cores but the main thread
+            if(workers == 0u)
+            {
+                workers = std::max(2u, std::thread::hardware_concurrency()) - 1u;
+            }
+
+            // queue 0 belongs to non-worker threads
+            m_Queues.resize(workers + 1u);
+            for(auto& queue : m_Queues)
+            {
+                queue = std::make_unique<WorkQueue>();
+            }
+
+            // start worker threads
+            for(uint32_t i = 1u; i <= workers; i++)
+            {
+                m_Workers.emplace_back([this, i] { WorkerLoop(i); });
+                if(pinThreads) { PinThread(m_Workers.back(), i); }
+            }
+        }
+
+        EMPY_INLINE ~JobSystem()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_SleepMutex);
+                m_Running = false;
+            }
+            m_WakeUp.notify_all();
+
+            for(auto& worker : m_Workers)
+            {
+                worker.join();
+            }
+        }
+
+        // pushes job on the calling thread's queue
+        EMPY_INLINE void Submit(JobFunction&& task, JobCounter* counter = nullptr)
+        {
+            // run inline when debugging
+            if(m_Serial)
+            {
+                task();
+                return;
+            }
+
+            if(counter)
+            {
+                counter->Pending.fetch_add(1u, std::memory_order_relaxed);
+            }
+
+            // lock keeps sleeping workers from missing the wake up
+            {
+                std::lock_guard<std::mutex> lock(m_SleepMutex);
+                m_Queued.fetch_add(1u, std::memory_order_release);
+            }
+
+            auto& queue = *m_Queues[ThreadIndex()];
+            {
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                queue.Jobs.push_back({ std::move(task), counter });
+            }
+            m_WakeUp.notify_one();
+        }
+
+        // executes pending jobs until counter reaches zero
+        EMPY_INLINE void Wait(JobCounter& counter)
+        {
+            while(!counter.Done())
+            {
+                if(!Help())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // executes one pending job if any
+        EMPY_INLINE bool Help()
+        {
+            Job job;
+            if(Pop(ThreadIndex(), job))
+            {
+                Execute(job);
+                return true;
+            }
+            return false;
+        }
+
+        // splits range into chunks run as jobs, task(begin, end)
+        template <typename Task>
+        EMPY_INLINE void ParallelFor(uint32_t count, uint32_t chunk, Task&& task)
+        {
+            if(count == 0u) { return; }
+
+            // default chunk size
+            if(chunk == 0u)
+            {
+                chunk = std::max(1u, count / (WorkerCount() * 4u));
+            }
+
+            // no need to dispatch
+            if(m_Serial || count <= chunk)
+            {
+                task(0u, count);
+                return;
+            }
+
+            JobCounter counter;
+            for(uint32_t begin = 0u; begin < count; begin += chunk)
+            {
+                uint32_t end = std::min(count, begin + chunk);
+                Submit([&task, begin, end] { task(begin, end); }, &counter);
+            }
+            Wait(counter);
+        }
+
+        // runs every job on the submitting thread
+        EMPY_INLINE void SetSerial(bool serial)
+        {
+            m_Serial = serial;
+        }
+
+        EMPY_INLINE bool IsSerial() const
+        {
+            return m_Serial;
+        }
+
+        EMPY_INLINE uint32_t WorkerCount() const
+        {
+            return static_cast<uint32_t>(m_Workers.size());
+        }
+
+        // 0 for non-worker threads, [1, n] for workers
+        EMPY_INLINE static uint32_t& ThreadIndex()
+        {
+            static thread_local uint32_t sIndex = 0u;
+            return sIndex;
+        }
+
+    private:
+        struct Job
+        {
+            JobFunction Task;
+            JobCounter* Counter = nullptr;
+        };
+
+        struct WorkQueue
+        {
+            std::deque<Job> Jobs;
+            std::mutex Mutex;
+        };
+
+        EMPY_INLINE void Execute(Job& job)
+        {
+            job.Task();
+            if(job.Counter)
+            {
+                job.Counter->Pending.fetch_sub(1u, std::memory_order_acq_rel);
+            }
+        }
+
+        // own queue is lifo, others are stolen fifo
+        EMPY_INLINE bool Pop(uint32_t index, Job& job)
+        {
+            if(m_Queued.load(std::memory_order_acquire) == 0u)
+            {
+                return false;
+            }
+
+            const uint32_t count = static_cast<uint32_t>(m_Queues.size());
+            for(uint32_t i = 0u; i < count; i++)
+            {
+                auto& queue = *m_Queues[(index + i) % count];
+                std::lock_guard<std::mutex> lock(queue.Mutex);
+                if(queue.Jobs.empty()) { continue; }
+
+                if(i == 0u)
+                {
+                    job = std::move(queue.Jobs.back());
+                    queue.Jobs.pop_back();
+                }
+                else
+                {
+                    job = std::move(queue.Jobs.front());
+                    queue.Jobs.pop_front();
+                }
+
+                m_Queued.fetch_sub(1u, std::memory_order_acq_rel);
+                return true;
+            }
+            return false;
+        }
+
+        // sets core affinity, wraps around on small machines
+        EMPY_INLINE static void PinThread(std::thread& thread, uint32_t core)
+        {
+            core %= std::max(1u, std::thread::hardware_concurrency());
+
+        #if defined(__linux__)
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(core, &cpuset);
+            if(pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
+            {
+                EMPY_WARN("failed to pin worker thread to core {}", core);
+            }
+        #else
+            EMPY_WARN("worker thread affinity not supported on this platform");
+        #endif
+        }
+
+        EMPY_INLINE void WorkerLoop(uint32_t index)
+        {
+            ThreadIndex() = index;
+            SampleProfiler::Get().RegisterThread();
+
+            while(true)
+            {
+                Job job;
+                if(Pop(index, job))
+                {
+                    Execute(job);
+                    continue;
+                }
+
+                // sleep until new jobs are queued
+                std::unique_lock<std::mutex> lock(m_SleepMutex);
+                m_WakeUp.wait(lock, [this]
+                {
+                    return !m_Running || m_Queued.load(std::memory_order_acquire) > 0u;
+                });
+
+                if(!m_Running) { break; }
+            }
+            SampleProfiler::Get().UnregisterThread();
+        }
+
+    private:
+        std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+        std::atomic<uint32_t> m_Queued = 0u;
+        std::vector<std::thread> m_Workers;
+        std::condition_variable m_WakeUp;
+        std::mutex m_SleepMutex;
+        bool m_Running = true;
+        bool m_Serial = false;
+    };
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "Core.h"
+#include <string_view>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace Empy
+{
+    // closed scope, steady clock nanoseconds
+    struct ProfileEvent
+    {
+        const char* Name = nullptr;
+        uint64_t Start = 0u;
+        uint64_t End = 0u;
+    };
+
+    // totals of one scope name over a frame
+    struct ProfileStat
+    {
+        const char* Name = nullptr;
+        uint32_t Calls = 0u;
+        // milliseconds
+        double Time = 0.0;
+    };
+
+    // ring of events written by one thread only
+    struct ProfileBuffer
+    {
+        static constexpr uint32_t CAPACITY = 1u << 14u;
+        std::array<ProfileEvent, CAPACITY> Events;
+        // events ever written, read at frame end
+        std::atomic<uint64_t> Head = 0u;
+        uint64_t Cursor = 0u;
+        uint32_t Thread = 0u;
+    };
+
+    struct Profiler
+    {
+        EMPY_INLINE static Profiler& Get()
+        {
+            static Profiler sProfiler;
+            return sProfiler;
+        }
+
+        EMPY_INLINE static uint64_t Now()
+        {
+            auto time = std::chrono::steady_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+        }
+
+        // scopes opened while disabled are dropped
+        EMPY_INLINE void SetEnabled(bool enabled)
+        {
+            m_Enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        EMPY_INLINE bool IsEnabled() const
+        {
+            return m_Enabled.load(std::memory_order_relaxed);
+        }
+
+        EMPY_INLINE void Push(const char* name, uint64_t start, uint64_t end)
+        {
+            auto& buffer = Local();
+            auto head = buffer.Head.load(std::memory_order_relaxed);
+            buffer.Events[head & (ProfileBuffer::CAPACITY - 1u)] = { name, start, end };
+            buffer.Head.store(head + 1u, std::memory_order_release);
+        }
+
+        // totals scopes closed since last call, call once per frame at a sync point
+        EMPY_INLINE void EndFrame()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Frame.clear();
+            m_Index.clear();
+
+            for(auto& buffer : m_Buffers)
+            {
+                auto head = buffer->Head.load(std::memory_order_acquire);
+                auto first = std::max(buffer->Cursor, head - std::min<uint64_t>(head, ProfileBuffer::CAPACITY));
+                for(auto i = first; i < head; i++)
+                {
+                    auto& event = buffer->Events[i & (ProfileBuffer::CAPACITY - 1u)];
+                    auto itr = m_Index.emplace(event.Name, static_cast<uint32_t>(m_Frame.size()));
+                    if(itr.second) { m_Frame.push_back({ event.Name, 0u, 0.0 }); }
+
+                    auto& stat = m_Frame[itr.first->second];
+                    stat.Time += (event.End - event.Start) * 1e-6;
+                    stat.Calls++;
+                }
+                buffer->Cursor = head;
+            }
+
+            auto now = Now();
+            m_FrameTime = m_FrameEnd ? (now - m_FrameEnd) * 1e-6 : 0.0;
+            m_FrameEnd = now;
+        }
+
+        // totals of the last closed frame
+        EMPY_INLINE const std::vector<ProfileStat>& Frame() const
+        {
+            return m_Frame;
+        }
+
+        // milliseconds between the last two EndFrame() calls
+        EMPY_INLINE double FrameTime() const
+        {
+            return m_FrameTime;
+        }
+
+        // chrome trace-event json of the events left in the rings
+        EMPY_INLINE bool ExportTrace(const std::string& path)
+        {
+            std::error_code error;
+            auto directory = std::filesystem::path(path).parent_path();
+            if(!directory.empty()) { std::filesystem::create_directories(directory, error); }
+
+            std::ofstream stream(path);
+            if(!stream)
+            {
+                EMPY_ERROR("failed to write trace: {}", path);
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            stream << "{\"traceEvents\":[";
+            bool first = true;
+
+            for(auto& buffer : m_Buffers)
+            {
+                auto head = buffer->Head.load(std::memory_order_acquire);
+                auto begin = head - std::min<uint64_t>(head, ProfileBuffer::CAPACITY);
+                for(auto i = begin; i < head; i++)
+                {
+                    auto& event = buffer->Events[i & (ProfileBuffer::CAPACITY - 1u)];
+                    stream << (first ? "" : ",") << "\n{\"name\":\"" << event.Name
+                        << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->Thread
+                        << ",\"ts\":" << (event.Start / 1000u)
+                        << ",\"dur\":" << ((event.End - event.Start) / 1000u) << "}";
+                    first = false;
+                }
+            }
+            stream << "\n]}\n";
+            return true;
+        }
+
+    private:
+        EMPY_INLINE Profiler() = default;
+
+        // ring of the calling thread, created on first use
+        EMPY_INLINE ProfileBuffer& Local()
+        {
+            thread_local ProfileBuffer* tBuffer = nullptr;
+            if(!tBuffer)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Buffers.push_back(std::make_unique<ProfileBuffer>());
+                m_Buffers.back()->Thread = static_cast<uint32_t>(m_Buffers.size() - 1u);
+                tBuffer = m_Buffers.back().get();
+            }
+            return *tBuffer;
+        }
+
+    private:
+        std::unordered_map<std::string_view, uint32_t> m_Index;
+        std::vector<std::unique_ptr<ProfileBuffer>> m_Buffers;
+        std::vector<ProfileStat> m_Frame;
+        std::atomic<bool> m_Enabled = true;
+        double m_FrameTime = 0.0;
+        uint64_t m_FrameEnd = 0u;
+        std::mutex m_Mutex;
+    };
+
+    // times its lifetime, name must outlive the profiler
+    struct ProfileScope
+    {
+        EMPY_INLINE ProfileScope(const char* name):
+            m_Name(name), m_Start(Profiler::Get().IsEnabled() ? Profiler::Now() : 0u)
+        {}
+
+        EMPY_INLINE ~ProfileScope()
+        {
+            if(m_Start) { Profiler::Get().Push(m_Name, m_Start, Profiler::Now()); }
+        }
+
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+    };
+}
+
+    // profiling macros
+#ifdef EMPY_ENABLE_PROFILE
+    #define EMPY_PROFILE_JOIN_(a, b) a##b
+    #define EMPY_PROFILE_JOIN(a, b) EMPY_PROFILE_JOIN_(a, b)
+    #define EMPY_PROFILE_SCOPE(name) Empy::ProfileScope EMPY_PROFILE_JOIN(sProfileScope, __LINE__)(name)
+    #define EMPY_PROFILE_FRAME() Empy::Profiler::Get().EndFrame()
+#else
+    #define EMPY_PROFILE_SCOPE(name)
+    #define EMPY_PROFILE_FRAME()
+#endif
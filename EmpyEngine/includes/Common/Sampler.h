@@ -0,0 +1,252 @@
+#pragma once
+#include "Core.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <map>
+
+#if defined(__linux__)
+    #include <cxxabi.h>
+    #include <execinfo.h>
+    #include <pthread.h>
+    #include <signal.h>
+    #include <dlfcn.h>
+    #include <link.h>
+#endif
+
+namespace Empy
+{
+    // statistical profiler, signals registered threads and records their stacks
+    struct SampleProfiler
+    {
+        static constexpr uint32_t MAX_SAMPLES = 1u << 16u;
+        static constexpr uint32_t MAX_DEPTH = 48u;
+
+        EMPY_INLINE static SampleProfiler& Get()
+        {
+            static SampleProfiler sProfiler;
+            return sProfiler;
+        }
+
+        // calling thread gets sampled while running
+        EMPY_INLINE void RegisterThread()
+        {
+        #if defined(__linux__)
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto self = pthread_self();
+            for(auto thread : m_Threads) { if(pthread_equal(thread, self)) { return; } }
+            m_Threads.push_back(self);
+        #endif
+        }
+
+        EMPY_INLINE void UnregisterThread()
+        {
+        #if defined(__linux__)
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto self = pthread_self();
+            m_Threads.erase(std::remove_if(m_Threads.begin(), m_Threads.end(),
+                [self] (pthread_t thread) { return pthread_equal(thread, self); }), m_Threads.end());
+        #endif
+        }
+
+        // clears old samples and starts signaling at rate hz
+        EMPY_INLINE bool Start(uint32_t hz = 1000u)
+        {
+        #if defined(__linux__)
+            if(m_Running.exchange(true)) { return false; }
+            if(m_Ticker.joinable()) { m_Ticker.join(); }
+
+            // allocated on first start, slots are ready once their depth is set
+            if(!m_Samples) { m_Samples.reset(new Sample[MAX_SAMPLES]); }
+            for(uint32_t i = 0u; i < MAX_SAMPLES; i++) { m_Samples[i].Depth.store(0u, std::memory_order_relaxed); }
+            m_Count.store(0u, std::memory_order_relaxed);
+
+            // first backtrace loads libgcc, never inside the handler
+            void* warm[4];
+            backtrace(warm, 4);
+
+            struct sigaction action = {};
+            action.sa_handler = OnSignal;
+            action.sa_flags = SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGPROF, &action, nullptr);
+
+            auto period = std::chrono::microseconds(1000000u / std::max(1u, hz));
+            m_Ticker = std::thread([this, period] { TickerLoop(period); });
+            return true;
+        #else
+            EMPY_WARN("sampling profiler is only available on linux!");
+            return false;
+        #endif
+        }
+
+        // ticker may have stopped itself once samples are full
+        EMPY_INLINE void Stop()
+        {
+            m_Running.store(false, std::memory_order_relaxed);
+            if(m_Ticker.joinable()) { m_Ticker.join(); }
+        #if defined(__linux__)
+            signal(SIGPROF, SIG_IGN);
+        #endif
+        }
+
+        EMPY_INLINE bool IsRunning() const
+        {
+            return m_Running.load(std::memory_order_relaxed);
+        }
+
+        EMPY_INLINE uint32_t Samples() const
+        {
+            return std::min(m_Count.load(std::memory_order_acquire), MAX_SAMPLES);
+        }
+
+        // folded stacks, "root;caller;callee count" per line, frames
+        // without a symbol are "module+0xoffset" for addr2line
+        EMPY_INLINE bool WriteFolded(const std::string& path)
+        {
+            Stop();
+
+            std::error_code error;
+            auto directory = std::filesystem::path(path).parent_path();
+            if(!directory.empty()) { std::filesystem::create_directories(directory, error); }
+
+            std::ofstream stream(path);
+            if(!stream)
+            {
+                EMPY_ERROR("failed to write samples: {}", path);
+                return false;
+            }
+
+            std::unordered_map<void*, std::string> symbols;
+            std::map<std::string, uint32_t> stacks;
+            for(uint32_t i = 0u; i < Samples(); i++)
+            {
+                auto& sample = m_Samples[i];
+                auto depth = sample.Depth.load(std::memory_order_acquire);
+                std::string stack;
+
+                // handler and signal trampoline come first,
+                // callers hold return addresses, step back into the call
+                for(uint32_t k = depth; k > SKIP_FRAMES; k--)
+                {
+                    auto address = sample.Frames[k - 1u];
+                    if(k - 1u > SKIP_FRAMES) { address = static_cast<uint8_t*>(address) - 1; }
+                    auto itr = symbols.find(address);
+                    if(itr == symbols.end()) { itr = symbols.emplace(address, Symbolize(address)).first; }
+                    if(!stack.empty()) { stack += ';'; }
+                    stack += itr->second;
+                }
+                if(!stack.empty()) { stacks[stack]++; }
+            }
+
+            for(auto& [stack, count] : stacks)
+            {
+                stream << stack << ' ' << count << '\n';
+            }
+            return true;
+        }
+
+    private:
+        static constexpr uint32_t SKIP_FRAMES = 2u;
+
+        // zero depth until the handler finished writing frames
+        struct Sample
+        {
+            void* Frames[MAX_DEPTH];
+            std::atomic<uint32_t> Depth = 0u;
+        };
+
+        EMPY_INLINE SampleProfiler() = default;
+
+        EMPY_INLINE ~SampleProfiler()
+        {
+            Stop();
+        }
+
+    #if defined(__linux__)
+        // claims a slot and publishes it filled, async signal safe
+        EMPY_INLINE static void OnSignal(int32_t)
+        {
+            auto& self = Get();
+            auto index = self.m_Count.fetch_add(1u, std::memory_order_acq_rel);
+            if(index >= MAX_SAMPLES) { return; }
+
+            auto& sample = self.m_Samples[index];
+            auto depth = static_cast<uint32_t>(backtrace(sample.Frames, MAX_DEPTH));
+            sample.Depth.store(depth, std::memory_order_release);
+        }
+
+        EMPY_INLINE void TickerLoop(std::chrono::microseconds period)
+        {
+            auto next = std::chrono::steady_clock::now();
+            while(m_Running.load(std::memory_order_relaxed))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    for(auto thread : m_Threads) { pthread_kill(thread, SIGPROF); }
+                }
+
+                next += period;
+                std::this_thread::sleep_until(next);
+                if(m_Count.load(std::memory_order_relaxed) >= MAX_SAMPLES)
+                {
+                    m_Running.store(false, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+
+        // demangled function name, module offset for stripped or static code
+        EMPY_INLINE static std::string Symbolize(void* address)
+        {
+            Dl_info info;
+            link_map* module = nullptr;
+            std::string symbol;
+            if(!dladdr1(address, &info, reinterpret_cast<void**>(&module), RTLD_DL_LINKMAP))
+            {
+                std::stringstream stream;
+                stream << address;
+                return stream.str();
+            }
+
+            if(info.dli_sname)
+            {
+                int32_t status = 0;
+                auto name = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                symbol = (status == 0 && name) ? name : info.dli_sname;
+                std::free(name);
+            }
+            else
+            {
+                // load bias is zero for non pie executables
+                auto bias = module ? static_cast<uintptr_t>(module->l_addr) : 0u;
+                std::stringstream stream;
+                stream << (info.dli_fname ? info.dli_fname : "?") << "+0x" << std::hex 
+                    << (reinterpret_cast<uintptr_t>(address) - bias);
+                symbol = stream.str();
+            }
+
+            // ';' separates frames in folded output
+            std::replace(symbol.begin(), symbol.end(), ';', ':');
+            return symbol;
+        }
+    #else
+        EMPY_INLINE static std::string Symbolize(void* address)
+        {
+            std::stringstream stream;
+            stream << address;
+            return stream.str();
+        }
+    #endif
+
+    private:
+        std::atomic<uint32_t> m_Count = 0u;
+        std::atomic<bool> m_Running = false;
+        std::unique_ptr<Sample[]> m_Samples;
+    #if defined(__linux__)
+        std::vector<pthread_t> m_Threads;
+    #endif
+        std::thread m_Ticker;
+        std::mutex m_Mutex;
+    };
+}
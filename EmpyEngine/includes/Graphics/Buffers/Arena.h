@@ -0,0 +1,332 @@
+#pragma once
+#include "Vertex.h"
+#include "../Utilities/State.h"
+#include <map>
+
+namespace Empy
+{
+    // gpu bytes held by the geometry arenas
+    struct GeometryMemory
+    {
+        size_t Reserved = 0u;
+        size_t Used = 0u;
+    };
+
+    EMPY_INLINE GeometryMemory& GeometryUsage()
+    {
+        static GeometryMemory sMemory;
+        return sMemory;
+    }
+
+    // gl release of each arena, in creation order
+    EMPY_INLINE std::vector<void(*)()>& GeometryShutdowns()
+    {
+        static std::vector<void(*)()> sShutdowns;
+        return sShutdowns;
+    }
+
+    // deletes gl objects of all arenas, call while the context is current,
+    // static arenas outlive glfw and only keep their bookkeeping
+    EMPY_INLINE void ShutdownGeometry()
+    {
+        auto& shutdowns = GeometryShutdowns();
+        for(auto it = shutdowns.rbegin(); it != shutdowns.rend(); ++it) { (*it)(); }
+        shutdowns.clear();
+    }
+
+    // first fit allocator over a range of elements
+    struct FreeList
+    {
+        static constexpr uint32_t INVALID = ~0u;
+
+        // offset of count free elements, INVALID when nothing fits
+        EMPY_INLINE uint32_t Allocate(uint32_t count)
+        {
+            for(auto it = m_Blocks.begin(); it != m_Blocks.end(); ++it)
+            {
+                if(it->second < count) { continue; }
+                auto offset = it->first;
+                auto rest = it->second - count;
+                m_Blocks.erase(it);
+                if(rest != 0u) { m_Blocks.emplace(offset + count, rest); }
+                return offset;
+            }
+            return INVALID;
+        }
+
+        // merges the range with free neighbours
+        EMPY_INLINE void Free(uint32_t offset, uint32_t count)
+        {
+            if(count == 0u) { return; }
+            auto next = m_Blocks.lower_bound(offset);
+            if(next != m_Blocks.end() && offset + count == next->first)
+            {
+                count += next->second;
+                next = m_Blocks.erase(next);
+            }
+            if(next != m_Blocks.begin())
+            {
+                auto prev = std::prev(next);
+                if(prev->first + prev->second == offset)
+                {
+                    prev->second += count;
+                    return;
+                }
+            }
+            m_Blocks.emplace(offset, count);
+        }
+
+    private:
+        // offset to size
+        std::map<uint32_t, uint32_t> m_Blocks;
+    };
+
+    // growable gl buffer, suballocated in elements of one size
+    struct ArenaBuffer
+    {
+        EMPY_INLINE ArenaBuffer(uint32_t stride, uint32_t capacity) : m_Stride(stride)
+        {
+            glGenBuffers(1, &m_Buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, size_t(capacity) * m_Stride, nullptr, GL_STATIC_DRAW);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            GeometryUsage().Reserved += size_t(capacity) * m_Stride;
+            m_Free.Free(0u, capacity);
+            m_Capacity = capacity;
+        }
+
+        EMPY_INLINE ~ArenaBuffer()
+        {
+            GeometryUsage().Reserved -= size_t(m_Capacity) * m_Stride;
+            GeometryUsage().Used -= size_t(m_Used) * m_Stride;
+        }
+
+        // deletes the gl buffer, ranges stay tracked
+        EMPY_INLINE void Release()
+        {
+            if(m_Buffer) { glDeleteBuffers(1, &m_Buffer); }
+            m_Buffer = 0u;
+        }
+
+        // uploads count elements, moved tells callers to rebind the buffer
+        EMPY_INLINE uint32_t Allocate(const void* data, uint32_t count, bool& moved)
+        {
+            moved = false;
+            auto offset = m_Free.Allocate(count);
+            if(offset == FreeList::INVALID)
+            {
+                Grow(std::max(m_Capacity * 2u, m_Capacity + count));
+                offset = m_Free.Allocate(count);
+                moved = true;
+            }
+
+            // copy target keeps vertex array bindings untouched
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, size_t(offset) * m_Stride, size_t(count) * m_Stride, data);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            GeometryUsage().Used += size_t(count) * m_Stride;
+            m_Used += count;
+            return offset;
+        }
+
+        EMPY_INLINE void Free(uint32_t offset, uint32_t count)
+        {
+            GeometryUsage().Used -= size_t(count) * m_Stride;
+            m_Free.Free(offset, count);
+            m_Used -= count;
+        }
+
+        EMPY_INLINE uint32_t ID() const
+        {
+            return m_Buffer;
+        }
+
+    private:
+        // copies live data into a larger buffer, offsets stay valid
+        EMPY_INLINE void Grow(uint32_t capacity)
+        {
+            uint32_t buffer = 0u;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, size_t(capacity) * m_Stride, nullptr, GL_STATIC_DRAW);
+            glBindBuffer(GL_COPY_READ_BUFFER, m_Buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size_t(m_Capacity) * m_Stride);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &m_Buffer);
+
+            GeometryUsage().Reserved += size_t(capacity - m_Capacity) * m_Stride;
+            m_Free.Free(m_Capacity, capacity - m_Capacity);
+            m_Capacity = capacity;
+            m_Buffer = buffer;
+        }
+
+    private:
+        uint32_t m_Capacity = 0u;
+        uint32_t m_Buffer = 0u;
+        uint32_t m_Stride = 0u;
+        uint32_t m_Used = 0u;
+        FreeList m_Free;
+    };
+
+    // index buffer shared by all vertex layouts
+    struct IndexArena
+    {
+        static constexpr uint32_t CAPACITY = 1u << 16u;
+
+        EMPY_INLINE static IndexArena& Get()
+        {
+            static IndexArena sArena;
+            return sArena;
+        }
+
+        // vertex arrays that read from this buffer
+        EMPY_INLINE void Attach(uint32_t array)
+        {
+            m_Arrays.push_back(array);
+            GLState::Get().BindVertexArray(array);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Buffer.ID());
+        }
+
+        EMPY_INLINE void Detach(uint32_t array)
+        {
+            m_Arrays.erase(std::remove(m_Arrays.begin(), m_Arrays.end(), array), m_Arrays.end());
+        }
+
+        EMPY_INLINE uint32_t Allocate(const std::vector<uint32_t>& indices)
+        {
+            bool moved = false;
+            auto offset = m_Buffer.Allocate(indices.data(), static_cast<uint32_t>(indices.size()), moved);
+            if(!moved) { return offset; }
+
+            // element buffer binding is vertex array state
+            for(auto array : m_Arrays)
+            {
+                GLState::Get().BindVertexArray(array);
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Buffer.ID());
+            }
+            return offset;
+        }
+
+        EMPY_INLINE void Free(uint32_t offset, uint32_t count)
+        {
+            m_Buffer.Free(offset, count);
+        }
+
+    private:
+        EMPY_INLINE IndexArena() : m_Buffer(sizeof(uint32_t), CAPACITY)
+        {
+            GeometryShutdowns().push_back([] { Get().Shutdown(); });
+        }
+
+        EMPY_INLINE void Shutdown()
+        {
+            m_Buffer.Release();
+            m_Arrays.clear();
+        }
+
+    private:
+        std::vector<uint32_t> m_Arrays;
+        ArenaBuffer m_Buffer;
+    };
+
+    // one vertex buffer and vertex array per vertex layout
+    template <typename Vertex> struct VertexArena
+    {
+        static constexpr uint32_t CAPACITY = 1u << 12u;
+
+        EMPY_INLINE static VertexArena& Get()
+        {
+            static VertexArena sArena;
+            return sArena;
+        }
+
+        // base vertex of the uploaded vertices
+        EMPY_INLINE uint32_t Allocate(const std::vector<Vertex>& vertices)
+        {
+            bool moved = false;
+            auto offset = m_Buffer.Allocate(vertices.data(), static_cast<uint32_t>(vertices.size()), moved);
+            if(moved) { SetLayout(); }
+            return offset;
+        }
+
+        EMPY_INLINE void Free(uint32_t offset, uint32_t count)
+        {
+            m_Buffer.Free(offset, count);
+        }
+
+        EMPY_INLINE void Bind()
+        {
+            GLState::Get().BindVertexArray(m_Array);
+        }
+
+    private:
+        EMPY_INLINE VertexArena() : m_Buffer(sizeof(Vertex), CAPACITY)
+        {
+            glGenVertexArrays(1, &m_Array);
+            IndexArena::Get().Attach(m_Array);
+            GeometryShutdowns().push_back([] { Get().Shutdown(); });
+            SetLayout();
+        }
+
+        EMPY_INLINE void Shutdown()
+        {
+            IndexArena::Get().Detach(m_Array);
+            GLState::Get().DeleteVertexArrays(1, &m_Array);
+            m_Buffer.Release();
+            m_Array = 0u;
+        }
+
+        // attributes point into the current vertex buffer
+        EMPY_INLINE void SetLayout()
+        {
+            GLState::Get().BindVertexArray(m_Array);
+            glBindBuffer(GL_ARRAY_BUFFER, m_Buffer.ID());
+
+            // handle vertex types
+            if (TypeID<Vertex>() == TypeID<ShadedVertex>())
+            {
+                SetAttribute(0, 3, (void*)offsetof(ShadedVertex, Position));
+                SetAttribute(1, 3, (void*)offsetof(ShadedVertex, Normal));
+                SetAttribute(2, 2, (void*)offsetof(ShadedVertex, UVs));
+                SetAttribute(3, 3, (void*)offsetof(ShadedVertex, Tangent));
+                SetAttribute(4, 3, (void*)offsetof(ShadedVertex, Bitangent));
+            }
+            else if (TypeID<Vertex>() == TypeID<SkeletalVertex>())
+            {
+                SetAttribute(0, 3, (void*)offsetof(SkeletalVertex, Position));
+                SetAttribute(1, 3, (void*)offsetof(SkeletalVertex, Normal));
+                SetAttribute(2, 2, (void*)offsetof(SkeletalVertex, UVs));
+                SetAttribute(3, 3, (void*)offsetof(SkeletalVertex, Tangent));
+                SetAttribute(4, 3, (void*)offsetof(SkeletalVertex, Bitangent));
+                SetAttribute(5, 4, (void*)offsetof(SkeletalVertex, Joints));
+                SetAttribute(6, 4, (void*)offsetof(SkeletalVertex, Weights));
+            }
+            else if (TypeID<Vertex>() == TypeID<QuadVertex>())
+            {
+                SetAttribute(0, 4, (void*)offsetof(QuadVertex, Data));
+            }
+            else if (TypeID<Vertex>() == TypeID<SkyboxVertex>())
+            {
+                SetAttribute(0, 3, (void*)offsetof(SkyboxVertex, Position));
+            }
+            else
+            {
+                EMPY_ERROR("invalid vertex type!");
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        EMPY_INLINE void SetAttribute(uint32_t index, int32_t size, const void* value)
+        {
+            glEnableVertexAttribArray(index);
+            glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, sizeof(Vertex), value);
+        }
+
+    private:
+        uint32_t m_Array = 0u;
+        ArenaBuffer m_Buffer;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Common/Core.h"
+#include "../Utilities/State.h"
 
 namespace Empy
 {
@@ -41,12 +42,12 @@ namespace Empy
             m_Height = height;
 
             // Resize Color Buffer
-            glBindTexture(GL_TEXTURE_2D, m_Color);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Color);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 
             m_Width, m_Height, 0, GL_RGBA, GL_FLOAT, NULL);
 
             // Resize Brightness Buffer
-            glBindTexture(GL_TEXTURE_2D, m_Brightness);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Brightness);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 
             m_Width, m_Height, 0, GL_RGBA, GL_FLOAT, NULL);
 
@@ -55,7 +56,7 @@ namespace Empy
             glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Width, m_Height);
 
             glBindRenderbuffer(GL_RENDERBUFFER, 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
         }       
 
         EMPY_INLINE uint32_t GetBrightnessMap() 
@@ -80,8 +81,8 @@ namespace Empy
 
         EMPY_INLINE ~FrameBuffer() 
         {
-            glDeleteTextures(1, &m_Color); 
-            glDeleteTextures(1, &m_Brightness); 
+            GLState::Get().DeleteTextures(1, &m_Color); 
+            GLState::Get().DeleteTextures(1, &m_Brightness); 
             glDeleteRenderbuffers(1, &m_Render); 
             glDeleteFramebuffers(1, &m_FBO); 
         }
@@ -114,7 +115,7 @@ namespace Empy
         EMPY_INLINE void CreateBrightnessAttachment() 
         {
             glGenTextures(1, &m_Brightness);
-            glBindTexture(GL_TEXTURE_2D, m_Brightness);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Brightness);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -126,7 +127,7 @@ namespace Empy
         EMPY_INLINE void CreateColorAttachment() 
         {
             glGenTextures(1, &m_Color);
-            glBindTexture(GL_TEXTURE_2D, m_Color);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Color);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -0,0 +1,90 @@
+#pragma once
+#include "Common/Core.h"
+#include "../Utilities/State.h"
+
+namespace Empy
+{
+    // world matrices of one frame, read by shaders as texture buffers,
+    // split in pages no larger than GL_MAX_TEXTURE_BUFFER_SIZE
+    struct InstanceBuffer
+    {
+        EMPY_INLINE InstanceBuffer()
+        {
+            // four rgba texels per matrix
+            int32_t texels = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+            m_Capacity = std::max<uint32_t>(static_cast<uint32_t>(texels) / 4u, 1u);
+            AddPage();
+        }
+
+        EMPY_INLINE ~InstanceBuffer()
+        {
+            for(auto& page : m_Pages)
+            {
+                GLState::Get().DeleteTextures(1, &page.Texture);
+                glDeleteBuffers(1, &page.Buffer);
+            }
+        }
+
+        // matrices one page holds
+        EMPY_INLINE uint32_t Capacity() const
+        {
+            return m_Capacity;
+        }
+
+        // replaces the buffer content, previous frame storage is orphaned
+        EMPY_INLINE void Upload(const std::vector<glm::mat4>& matrices)
+        {
+            auto pages = std::max<size_t>((matrices.size() + m_Capacity - 1u) / m_Capacity, 1u);
+            while(m_Pages.size() < pages) { AddPage(); }
+
+            for(size_t i = 0u; i < pages; i++)
+            {
+                auto first = i * m_Capacity;
+                auto count = std::min<size_t>(matrices.size() - std::min(first, matrices.size()), m_Capacity);
+                auto bytes = std::max<size_t>(count, 1u) * sizeof(glm::mat4);
+
+                glBindBuffer(GL_TEXTURE_BUFFER, m_Pages[i].Buffer);
+                glBufferData(GL_TEXTURE_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+                if(count != 0u)
+                {
+                    glBufferSubData(GL_TEXTURE_BUFFER, 0, count * sizeof(glm::mat4), matrices.data() + first);
+                }
+            }
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
+        EMPY_INLINE void Bind(int32_t unit, uint32_t page = 0u)
+        {
+            GLState::Get().ActiveTexture(GL_TEXTURE0 + unit);
+            GLState::Get().BindTexture(GL_TEXTURE_BUFFER, m_Pages[page].Texture);
+        }
+
+    private:
+        struct Page
+        {
+            uint32_t Texture = 0u;
+            uint32_t Buffer = 0u;
+        };
+
+        EMPY_INLINE void AddPage()
+        {
+            Page page;
+            glGenBuffers(1, &page.Buffer);
+            glGenTextures(1, &page.Texture);
+
+            glBindBuffer(GL_TEXTURE_BUFFER, page.Buffer);
+            glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+            GLState::Get().BindTexture(GL_TEXTURE_BUFFER, page.Texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, page.Buffer);
+
+            GLState::Get().BindTexture(GL_TEXTURE_BUFFER, 0);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            m_Pages.push_back(page);
+        }
+
+    private:
+        std::vector<Page> m_Pages;
+        uint32_t m_Capacity = 1u;
+    };
+}
@@ -1,10 +1,14 @@
 #pragma once
-#include "Vertex.h"
+#include "Arena.h"
 
 namespace Empy
 {
+	// range of the geometry arena of its vertex layout
 	template <typename Vertex> struct Mesh
 	{
+		EMPY_INLINE Mesh(const Mesh&) = delete;
+		EMPY_INLINE Mesh& operator=(const Mesh&) = delete;
+
 		EMPY_INLINE Mesh(MeshData<Vertex>& data) 
 		{
 			// check vertices
@@ -18,94 +22,87 @@ namespace Empy
 			m_NbrVertex = data.Vertices.size();
 			m_NbrIndex = data.Indices.size();
 
-			// generate vrtex buffer array
-			glGenVertexArrays(1, &m_BufferID);
-
-			// activate/bind vertex array
-			glBindVertexArray(m_BufferID);
-
-			// create vertex buffer
-			uint32_t VBO = 0u;
-			glGenBuffers(1, &VBO);
-			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			glBufferData(GL_ARRAY_BUFFER, m_NbrVertex * 
-			sizeof(Vertex), data.Vertices.data(), GL_STATIC_DRAW);
-
-			// create index buffer 
+			// indices stay relative to the base vertex
+			m_BaseVertex = VertexArena<Vertex>::Get().Allocate(data.Vertices);
 			if(m_NbrIndex != 0u) 
 			{
-				uint32_t EBO = 0u;
-				glGenBuffers(1, &EBO);
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-				glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_NbrIndex * 
-				sizeof(uint32_t), data.Indices.data(), GL_STATIC_DRAW);
+				m_FirstIndex = IndexArena::Get().Allocate(data.Indices);
 			}
-
-			// handle vertex types
-			if (TypeID<Vertex>() == TypeID<ShadedVertex>()) 
-			{
-				SetAttribute(0, 3, (void*)offsetof(ShadedVertex, Position));
-				SetAttribute(1, 3, (void*)offsetof(ShadedVertex, Normal));
-				SetAttribute(2, 2, (void*)offsetof(ShadedVertex, UVs));
-				SetAttribute(3, 3, (void*)offsetof(ShadedVertex, Tangent));
-				SetAttribute(4, 3, (void*)offsetof(ShadedVertex, Bitangent));
-			}
-			else if (TypeID<Vertex>() == TypeID<SkeletalVertex>()) 
-			{
-				SetAttribute(0, 3, (void*)offsetof(SkeletalVertex, Position));
-				SetAttribute(1, 3, (void*)offsetof(SkeletalVertex, Normal));
-				SetAttribute(2, 2, (void*)offsetof(SkeletalVertex, UVs));
-				SetAttribute(3, 3, (void*)offsetof(SkeletalVertex, Tangent));
-				SetAttribute(4, 3, (void*)offsetof(SkeletalVertex, Bitangent));
-				SetAttribute(5, 4, (void*)offsetof(SkeletalVertex, Joints));
-				SetAttribute(6, 4, (void*)offsetof(SkeletalVertex, Weights));
-			}			
-			else if (TypeID<Vertex>() == TypeID<QuadVertex>()) 
-			{
-				SetAttribute(0, 4, (void*)offsetof(QuadVertex, Data));
-			}	
-			else if (TypeID<Vertex>() == TypeID<SkyboxVertex>()) 
-			{
-				SetAttribute(0, 3, (void*)offsetof(SkyboxVertex, Position));
-			}
-			else 
-			{
-				EMPY_ERROR("invalid vertex type!");
-			}
-
-			// unbind vertext array
-			glBindVertexArray(0);
 		}
        	
-		EMPY_INLINE void Draw(uint32_t mode) 
+		EMPY_INLINE void Draw(uint32_t mode, uint32_t instances = 1u) 
 		{
-			glBindVertexArray(m_BufferID);
+			if(m_NbrVertex == 0u) { return; }
+			VertexArena<Vertex>::Get().Bind();
 			if(m_NbrIndex != 0u) 
 			{
-				glDrawElements(mode, m_NbrIndex, GL_UNSIGNED_INT, 0);
-				glBindVertexArray(0);
+				auto offset = IndexOffset();
+				auto base = static_cast<int32_t>(m_BaseVertex);
+				if(instances > 1u) { glDrawElementsInstancedBaseVertex(mode, m_NbrIndex, GL_UNSIGNED_INT, offset, instances, base); }
+				else { glDrawElementsBaseVertex(mode, m_NbrIndex, GL_UNSIGNED_INT, offset, base); }
 				return;
 			}
-			glDrawArrays(mode, 0, m_NbrVertex);
-			glBindVertexArray(0);
+			if(instances > 1u) { glDrawArraysInstanced(mode, m_BaseVertex, m_NbrVertex, instances); }
+			else { glDrawArrays(mode, m_BaseVertex, m_NbrVertex); }
 		}
 
         EMPY_INLINE ~Mesh() 
 		{ 
-			glDeleteVertexArrays(1, &m_BufferID); 
+			if(m_NbrVertex == 0u) { return; }
+			VertexArena<Vertex>::Get().Free(m_BaseVertex, m_NbrVertex);
+			if(m_NbrIndex != 0u) { IndexArena::Get().Free(m_FirstIndex, m_NbrIndex); }
 		}	
 
-    private:
-        EMPY_INLINE void SetAttribute(uint32_t index, int32_t size, const void* value) 
+		// byte offset into the index buffer
+		EMPY_INLINE const void* IndexOffset() const
 		{
-			glEnableVertexAttribArray(index);
-			glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, sizeof(Vertex), value);
+			return reinterpret_cast<const void*>(size_t(m_FirstIndex) * sizeof(uint32_t));
 		}
 
+		EMPY_INLINE uint32_t BaseVertex() const { return m_BaseVertex; }
+		EMPY_INLINE uint32_t IndexCount() const { return m_NbrIndex; }
+
 	private:
+		uint32_t m_BaseVertex = 0u;
+		uint32_t m_FirstIndex = 0u;
 		uint32_t m_NbrVertex = 0u;
 		uint32_t m_NbrIndex = 0u;
-		uint32_t m_BufferID = 0u;
+	};
+
+	// meshes of one model, single draws go out as one multi draw
+	template <typename Vertex> struct MeshGroup
+	{
+		EMPY_INLINE void Add(MeshData<Vertex>& data)
+		{
+			m_Meshes.push_back(std::make_unique<Mesh<Vertex>>(data));
+			auto& mesh = *m_Meshes.back();
+			if(mesh.IndexCount() == 0u) { return; }
+			m_Counts.push_back(static_cast<int32_t>(mesh.IndexCount()));
+			m_Bases.push_back(static_cast<int32_t>(mesh.BaseVertex()));
+			m_Offsets.push_back(mesh.IndexOffset());
+		}
+
+		EMPY_INLINE void Draw(uint32_t mode, uint32_t instances = 1u)
+		{
+			// no instanced multi draw before gl 4.3, unindexed meshes draw alone
+			if(instances > 1u || m_Counts.size() != m_Meshes.size() ||
+				!(GLEW_VERSION_3_2 || GLEW_ARB_draw_elements_base_vertex))
+			{
+				for(auto& mesh : m_Meshes) { mesh->Draw(mode, instances); }
+				return;
+			}
+			if(m_Counts.empty()) { return; }
+
+			VertexArena<Vertex>::Get().Bind();
+			glMultiDrawElementsBaseVertex(mode, m_Counts.data(), GL_UNSIGNED_INT, 
+				m_Offsets.data(), static_cast<int32_t>(m_Counts.size()), m_Bases.data());
+		}
+
+	private:
+		std::vector<std::unique_ptr<Mesh<Vertex>>> m_Meshes;
+		std::vector<const void*> m_Offsets;
+		std::vector<int32_t> m_Counts;
+		std::vector<int32_t> m_Bases;
 	};
 
 	// 3d mesh
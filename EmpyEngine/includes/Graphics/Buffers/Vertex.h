@@ -49,4 +49,7 @@ namespace Empy
 		std::vector<uint32_t> Indices;
 		std::vector<Vertex> Vertices;
 	};
+
+	// positions only, kept on cpu for physics
+	using CollisionData = MeshData<glm::vec3>;
 }
\ No newline at end of file
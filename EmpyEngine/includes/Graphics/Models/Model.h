@@ -13,9 +13,37 @@ namespace Empy
 	struct Model 
 	{
 		EMPY_INLINE virtual JointMatrices* Animate(float) { return nullptr; }
+		EMPY_INLINE virtual JointMatrices* Joints() { return nullptr; }
 		EMPY_INLINE virtual bool HasJoints() { return false; }
 		EMPY_INLINE virtual void Load(const std::string&) {}
-		EMPY_INLINE virtual void Draw(uint32_t) {}
+		// instances read their world matrix by gl_InstanceID
+		EMPY_INLINE virtual void Draw(uint32_t, uint32_t = 1u) {}
+
+		// merged geometry of all meshes
+		EMPY_INLINE const CollisionData& Collision() const 
+		{ 
+			return m_Collision; 
+		}
+
+	protected:
+		template <typename Vertex>
+		EMPY_INLINE void AppendCollision(const MeshData<Vertex>& data)
+		{
+			auto offset = static_cast<uint32_t>(m_Collision.Vertices.size());
+			for (auto& vertex : data.Vertices) 
+			{ 
+				m_Collision.Vertices.push_back(vertex.Position); 
+			}
+			for (auto index : data.Indices) 
+			{ 
+				m_Collision.Indices.push_back(offset + index); 
+			}
+		}
+
+	protected:
+		CollisionData m_Collision;
+		// skips gpu buffers, e.g. headless
+		bool m_CpuOnly = false;
 	};	
 
 	//  -------------------------------------------------------
@@ -25,18 +53,16 @@ namespace Empy
     {
         EMPY_INLINE StaticModel() = default;
 
-        EMPY_INLINE StaticModel(const std::string& path)
+        EMPY_INLINE StaticModel(const std::string& path, bool cpuOnly = false)
         {
+			m_CpuOnly = cpuOnly;
             Load(path);
         }
 		
-		EMPY_INLINE void Draw(uint32_t mode) override final
+		EMPY_INLINE void Draw(uint32_t mode, uint32_t instances = 1u) override final
         {
-			// render meshes
-            for(auto& mesh : m_Meshes)
-            {
-                mesh->Draw(mode);
-            }
+			// one multi draw per model
+            m_Meshes.Draw(mode, instances);
         }
 
         EMPY_INLINE void Load(const std::string& path) override final
@@ -94,8 +120,12 @@ namespace Empy
 				}
 			}
 
+			// keep positions for collision
+			AppendCollision(data);
+
             // create new mesh instance
-			m_Meshes.push_back(std::make_unique<ShadedMesh>(data));
+			if (m_CpuOnly) { return; }
+			m_Meshes.Add(data);
 		}
 		
 		EMPY_INLINE void ParseNode(const aiScene* ai_scene, aiNode* ai_node) 
@@ -112,7 +142,7 @@ namespace Empy
 		}
 
     private:
-        std::vector<std::unique_ptr<ShadedMesh>> m_Meshes;
+        MeshGroup<ShadedVertex> m_Meshes;
     };        
 
 	//  -------------------------------------------------------
@@ -124,8 +154,9 @@ namespace Empy
 
 		EMPY_INLINE SkeletalModel() = default;						
 
-		EMPY_INLINE SkeletalModel(const std::string& path)
+		EMPY_INLINE SkeletalModel(const std::string& path, bool cpuOnly = false)
 		{
+			m_CpuOnly = cpuOnly;
 			Load(path);
 		}
 		
@@ -134,13 +165,10 @@ namespace Empy
 			return m_JointCount; 
 		}
 
-		EMPY_INLINE void Draw(uint32_t mode) override final
+		EMPY_INLINE void Draw(uint32_t mode, uint32_t instances = 1u) override final
         {
-			// render meshes
-            for(auto& mesh : m_Meshes)
-            {
-                mesh->Draw(mode);
-            }
+			// one multi draw per model
+            m_Meshes.Draw(mode, instances);
         }
 
 		EMPY_INLINE void Load(const std::string& path) override final
@@ -178,6 +206,11 @@ namespace Empy
 			return m_Animator->Animate(dt);
 		}
 
+		EMPY_INLINE JointMatrices* Joints() override final
+		{
+			return &m_Animator->m_Joints;
+		}
+
 	private:
 		EMPY_INLINE void ParseNode(const aiScene* ai_scene, aiNode* ai_node, JointMap& jointMap) 
         {
@@ -321,12 +354,16 @@ namespace Empy
 				}
 			}
 
+			// keep positions for collision
+			AppendCollision(data);
+
             // create new mesh instance
-			m_Meshes.push_back(std::make_unique<SkeletalMesh>(data));
+			if (m_CpuOnly) { return; }
+			m_Meshes.Add(data);
 		}
 		
 	private:
-	 	std::vector<std::unique_ptr<SkeletalMesh>> m_Meshes;
+	 	MeshGroup<SkeletalVertex> m_Meshes;
 		std::shared_ptr<Animator> m_Animator;
 		uint32_t m_JointCount = 0;		
 	};
@@ -9,11 +9,38 @@
 #include "Shaders/Final.h"
 #include "Shaders/BRDF.h"
 #include "Shaders/PBR.h"
+#include "Utilities/Queue.h"
+#include "Common/Profiler.h"
 
 namespace Empy
 {
+    // models sharing a pass, model and material, drawn as one instanced call
+    struct RenderBatch
+    {
+        RenderPass Pass = RenderPass::DEPTH;
+        Material* Mtl = nullptr;
+        Model3D* Model = nullptr;
+        // instance buffer page and first matrix in it
+        uint32_t Page = 0u;
+        int32_t First = 0;
+        uint32_t Count = 0u;
+    };
+
+    // submitted model, world matrix stays in submit order
+    struct RenderItem
+    {
+        Material* Mtl = nullptr;
+        Model3D* Model = nullptr;
+        uint32_t World = 0u;
+        uint16_t MtlID = 0u;
+        uint16_t MeshID = 0u;
+    };
+
     struct GraphicsRenderer
-    {               
+    {
+        // texture unit of the instance matrices
+        static constexpr int32_t INSTANCE_UNIT = 13;
+               
         EMPY_INLINE GraphicsRenderer(int32_t width, int32_t height) 
         {
             // initialize opengl
@@ -42,26 +69,36 @@ namespace Empy
 
             m_Frame = std::make_unique<FrameBuffer>(width, height);  
             m_SkyboxMesh = CreateSkyboxMesh();
+            m_Clusters = std::make_unique<LightClusters>();
+            m_InstanceBuffer = std::make_unique<InstanceBuffer>();
         }
 
-        EMPY_INLINE void SetDirectLight(DirectLight& light, Transform3D& transform, uint32_t index) 
+        // meshes may outlive the renderer, their arena ranges are only bookkeeping then
+        EMPY_INLINE ~GraphicsRenderer()
         {
-            m_Pbr->SetDirectLight(light, transform, index);
+            ShutdownGeometry();
         }
 
-        EMPY_INLINE void SetPointLight(PointLight& light, Transform3D& transform, uint32_t index) 
+        EMPY_INLINE void SetDirectLight(DirectLight& light, Transform3D& transform, uint32_t index) 
         {
-            m_Pbr->SetPointLight(light, transform, index);
+            m_Pbr->SetDirectLight(light, transform, index);
         }
 
-        EMPY_INLINE void SetSpotLight(SpotLight& light, Transform3D& transform, uint32_t index) 
+        // bins point and spot lights for the camera set this frame
+        EMPY_INLINE void SetLights(const std::vector<std::pair<PointLight, Transform3D>>& points,
+            const std::vector<std::pair<SpotLight, Transform3D>>& spots, JobSystem& jobs) 
         {
-            m_Pbr->SetSpotLight(light, transform, index);
+            EMPY_PROFILE_SCOPE("LightClusters");
+            m_Clusters->Build(m_View, m_Proj, m_Camera.NearPlane, m_Camera.FarPlane, points, spots, jobs);
+
+            auto tile = glm::vec2(m_Frame->Width() / float(LightClusters::GRID_X), 
+                m_Frame->Height() / float(LightClusters::GRID_Y));
+            m_Pbr->SetClusters(*m_Clusters, tile, 10);
         }
 
-        EMPY_INLINE void Animate(Model3D model, float dt) 
+        EMPY_INLINE void SetJoints(Model3D& model) 
         {
-            if(auto joints = model->Animate(dt))
+            if(auto joints = model->Joints())
             {
                 m_Pbr->SetJoints(*joints);
             }
@@ -72,26 +109,113 @@ namespace Empy
             m_Pbr->SetDirectLightCount(count);
         }
 
-        EMPY_INLINE void SetPointLightCount(int32_t count)
+        // --
+
+        // queues a model for the batches of this frame
+        EMPY_INLINE void Submit(Model3D& model, Material& material, const glm::mat4& world)
         {
-            m_Pbr->SetPointLightCount(count);
+            RenderItem item = { &material, &model, static_cast<uint32_t>(m_Worlds.size()) };
+            item.MtlID = FrameID(m_MaterialIDs, &material);
+            item.MeshID = FrameID(m_MeshIDs, model.get());
+            m_Items.push_back(item);
+            m_Worlds.push_back(world);
         }
 
-        EMPY_INLINE void SetSpotLightCount(int32_t count)
+        // sorts submitted models by pass, state and depth, uploads their matrices
+        EMPY_INLINE void BuildBatches(JobSystem& jobs)
         {
-            m_Pbr->SetSpotLightCount(count);
+            EMPY_PROFILE_SCOPE("BuildBatches");
+            auto depthScale = 1.0f / std::max(m_Camera.FarPlane - m_Camera.NearPlane, 1e-4f);
+
+            m_Queue.Clear();
+            for(uint32_t i = 0u; i < m_Items.size(); i++)
+            {
+                auto& item = m_Items[i];
+                auto viewZ = -(m_View * m_Worlds[item.World][3]).z;
+                auto depth = (viewZ - m_Camera.NearPlane) * depthScale;
+
+                // depth ignores materials and joints, models merge per mesh
+                m_Queue.Push(RenderQueue::MakeKey(RenderPass::DEPTH, 0u, 0u, item.MeshID, depth), i);
+
+                auto variant = (*item.Model)->Joints() ? 1u : 0u;
+                m_Queue.Push(RenderQueue::MakeKey(RenderPass::COLOR, variant, 
+                    item.MtlID, item.MeshID, depth), i);
+            }
+            m_Queue.Sort(jobs);
+
+            m_Batches.clear();
+            m_Instances.clear();
+            uint64_t state = ~0ull;
+            auto capacity = m_InstanceBuffer->Capacity();
+            for(auto& packet : m_Queue.Packets())
+            {
+                auto& item = m_Items[packet.Item];
+                auto size = static_cast<uint32_t>(m_Instances.size());
+                // ids wrap past 16 bits, pointers settle those collisions,
+                // batches never cross an instance page
+                auto pass = RenderQueue::Pass(packet.Key);
+                if(RenderQueue::StateBits(packet.Key) != state || (size % capacity) == 0u ||
+                    m_Batches.back().Model->get() != item.Model->get() ||
+                    (pass == RenderPass::COLOR && m_Batches.back().Mtl != item.Mtl))
+                {
+                    state = RenderQueue::StateBits(packet.Key);
+                    m_Batches.push_back({ pass, item.Mtl, item.Model, size / capacity,
+                        static_cast<int32_t>(size % capacity), 0u });
+                }
+                m_Instances.push_back(m_Worlds[item.World]);
+                m_Batches.back().Count++;
+            }
+
+            m_InstanceBuffer->Upload(m_Instances);
+            m_MaterialIDs.clear();
+            m_MeshIDs.clear();
+            m_Items.clear();
+            m_Worlds.clear();
         }
-       
-        // --
 
-        EMPY_INLINE void Draw(Model3D& model, Material& material, Transform3D& transform)
+        EMPY_INLINE void DrawBatches()
         {
-            m_Pbr->Draw(model, material, transform);
+            uint32_t page = ~0u;
+            for(auto& batch : m_Batches)
+            {
+                if(batch.Pass != RenderPass::COLOR) { continue; }
+                if(batch.Page != page)
+                {
+                    m_Pbr->SetInstances(*m_InstanceBuffer, INSTANCE_UNIT, batch.Page);
+                    page = batch.Page;
+                }
+                SetJoints(*batch.Model);
+                m_Pbr->Draw(*batch.Model, *batch.Mtl, batch.First, batch.Count);
+                m_DrawCalls++;
+            }
+        }
+
+        EMPY_INLINE void DrawDepthBatches()
+        {
+            uint32_t page = ~0u;
+            for(auto& batch : m_Batches)
+            {
+                if(batch.Pass != RenderPass::DEPTH) { continue; }
+                if(batch.Page != page)
+                {
+                    m_Shadow->SetInstances(*m_InstanceBuffer, INSTANCE_UNIT, batch.Page);
+                    page = batch.Page;
+                }
+                m_Shadow->Draw(*batch.Model, batch.First, batch.Count);
+                m_DrawCalls++;
+            }
         }
 
-        EMPY_INLINE void DrawDepth(Model3D& model, Transform3D& transform)
+        // batches and instances built this frame
+        EMPY_INLINE uint32_t BatchCount() const
         {
-            m_Shadow->Draw(model, transform);
+            return static_cast<uint32_t>(m_Batches.size());
+        }
+
+        // matrices of both passes
+        EMPY_INLINE uint32_t InstanceCount() const
+        {
+            return static_cast<uint32_t>(m_Instances.size());
         }
 
         EMPY_INLINE void InitSkybox(Skybox& skybox, Texture2D& texture, int32_t size)
@@ -105,6 +229,7 @@ namespace Empy
         EMPY_INLINE void DrawSkybox(Skybox& skybox, Transform3D& transform)
         {            
             m_Skybox->Draw(m_SkyboxMesh, skybox.CubeMap, transform);
+            m_DrawCalls++;
             m_Pbr->SetEnvMaps(skybox.IrradMap, skybox.PrefilMap, 
             skybox.BrdfMap, m_Shadow->GetDepthMap());   
         }
@@ -120,6 +245,11 @@ namespace Empy
             // rebind pbr shader again
             m_Pbr->Bind();      
             m_Pbr->SetCamera(camera, transform, aspect);
+
+            // kept for light binning
+            m_Proj = camera.Projection(aspect);
+            m_View = camera.View(transform);
+            m_Camera = camera;
         }
                
         EMPY_INLINE void Resize(int32_t width, int32_t height) 
@@ -164,8 +294,21 @@ namespace Empy
         
         EMPY_INLINE void ShowFrame(bool useFBO)
         {
+            EMPY_PROFILE_SCOPE("ShowFrame");
+            // layers may have touched the context behind the cache
+            GLState::Get().Invalidate();
             glViewport(0, 0, m_Frame->Width(), m_Frame->Height());         
             m_Final->Render(m_Frame->GetTexture(), m_Bloom->GetMap(), useFBO);
+
+            m_LastDrawCalls = m_DrawCalls;
+            m_DrawCalls = 0u;
+            GLState::Get().EndFrame();
+        }
+
+        // batch and skybox draws of the last shown frame
+        EMPY_INLINE uint32_t DrawCalls() const
+        {
+            return m_LastDrawCalls;
         }          
 
         EMPY_INLINE void NewFrame()
@@ -180,9 +323,21 @@ namespace Empy
             m_Frame->End();
 
             // post-processing
+            EMPY_PROFILE_SCOPE("Bloom");
             m_Bloom->Compute(m_Frame->GetBrightnessMap(), 10);
         }   
 
+    private:
+        // dense per frame id, keys hold 16 bits
+        EMPY_INLINE static uint16_t FrameID(std::unordered_map<const void*, uint16_t>& ids, const void* key)
+        {
+            auto it = ids.find(key);
+            if(it != ids.end()) { return it->second; }
+            auto id = static_cast<uint16_t>(ids.size() & 0xFFFFu);
+            ids.emplace(key, id);
+            return id;
+        }
+
     private:
         std::unique_ptr<PrefilteredShader> m_Prefil;        
         std::unique_ptr<IrradianceShader> m_Irrad;
@@ -194,7 +349,25 @@ namespace Empy
         std::unique_ptr<BrdfShader> m_Brdf;
         std::unique_ptr<PbrShader> m_Pbr;    
 
+        std::unique_ptr<InstanceBuffer> m_InstanceBuffer;
+        std::unique_ptr<LightClusters> m_Clusters;
         std::unique_ptr<FrameBuffer> m_Frame;
         SkyboxMesh m_SkyboxMesh;
+
+        std::vector<glm::mat4> m_Instances;
+        std::vector<RenderBatch> m_Batches;
+        std::vector<glm::mat4> m_Worlds;
+        std::vector<RenderItem> m_Items;
+        RenderQueue m_Queue;
+
+        std::unordered_map<const void*, uint16_t> m_MaterialIDs;
+        std::unordered_map<const void*, uint16_t> m_MeshIDs;
+
+        glm::mat4 m_View = glm::mat4(1.0f);
+        glm::mat4 m_Proj = glm::mat4(1.0f);
+        Camera3D m_Camera;
+
+        uint32_t m_LastDrawCalls = 0u;
+        uint32_t m_DrawCalls = 0u;
     };
 }
\ No newline at end of file
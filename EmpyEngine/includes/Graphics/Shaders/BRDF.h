@@ -14,14 +14,14 @@ namespace Empy
         {            
             uint32_t brdfMap = 0u; 
             glGenTextures(1, &brdfMap);
-            glBindTexture(GL_TEXTURE_2D, brdfMap);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, brdfMap);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, size, size, 0, GL_RG, GL_FLOAT, 0);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-            glUseProgram(m_ShaderID); 
+            GLState::Get().UseProgram(m_ShaderID); 
 
             uint32_t FBO, RBO = 0;
             glGenFramebuffers(1, &FBO);
@@ -37,8 +37,8 @@ namespace Empy
             CreateQuad2D()->Draw(GL_TRIANGLES);
 
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glUseProgram(0); 
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
+            GLState::Get().UseProgram(0); 
 
             // delete fbo & rbo
             glDeleteRenderbuffers(1, &RBO);
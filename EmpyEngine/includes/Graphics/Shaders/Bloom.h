@@ -9,10 +9,6 @@ namespace Empy
         EMPY_INLINE BloomShader(const std::string& path, int32_t width, int32_t height): 
         Shader(path), m_Width(width), m_Height(height) 
         {
-            u_HorizontalPass = glGetUniformLocation(m_ShaderID, "u_horizontalPass");
-            u_BrightnessMap = glGetUniformLocation(m_ShaderID, "u_brightnessMap");            
-            u_FrameHeight = glGetUniformLocation(m_ShaderID, "u_frameHeight");
-            u_FrameWidth = glGetUniformLocation(m_ShaderID, "u_frameWidth");
             m_Quad = CreateQuad2D();
 
             // --------------------------------------------------
@@ -33,7 +29,7 @@ namespace Empy
                 glBindFramebuffer(GL_FRAMEBUFFER, m_GausianFBO[i]);
 
                 // bind current texture 
-                glBindTexture(GL_TEXTURE_2D, m_PingPongMaps[i]);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, m_PingPongMaps[i]);
                 glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 
                 m_Width, m_Height, 0, GL_RGBA, GL_FLOAT, NULL);
 
@@ -62,16 +58,16 @@ namespace Empy
         EMPY_INLINE void Compute(uint32_t brightnessMap, uint32_t stepCount)
         {
             // bind shader program
-            glUseProgram(m_ShaderID);
+            GLState::Get().UseProgram(m_ShaderID);
 
             // set brightness map
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, brightnessMap);
-            glUniform1i(u_BrightnessMap, 0);
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, brightnessMap);
+            SetUniform(EMPY_UNIFORM("u_brightnessMap"), 0);
 
             // set frame size
-            glUniform1i(u_FrameHeight, m_Height);
-            glUniform1i(u_FrameWidth, m_Width);
+            SetUniform(EMPY_UNIFORM("u_frameHeight"), m_Height);
+            SetUniform(EMPY_UNIFORM("u_frameWidth"), m_Width);
 
             // set viewport a clear buffer
             glViewport(0, 0, m_Width, m_Height);
@@ -82,13 +78,13 @@ namespace Empy
 			for (uint32_t i = 0u; i < stepCount; i++) 
             {
                 glBindFramebuffer(GL_FRAMEBUFFER, m_GausianFBO[horizontal]); 
-                glUniform1i(u_HorizontalPass, horizontal);
+                SetUniform(EMPY_UNIFORM("u_horizontalPass"), static_cast<int32_t>(horizontal));
 
 				if (i > 0) 
                 {
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, m_PingPongMaps[!horizontal]);
-                    glUniform1i(u_BrightnessMap, 0);					
+                    GLState::Get().ActiveTexture(GL_TEXTURE0);
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, m_PingPongMaps[!horizontal]);
+                    SetUniform(EMPY_UNIFORM("u_brightnessMap"), 0);					
 				}
 
 				m_Quad->Draw(GL_TRIANGLES);
@@ -96,8 +92,8 @@ namespace Empy
 			}
 
             glBindFramebuffer(GL_FRAMEBUFFER, 0); 
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glUseProgram(0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
+            GLState::Get().UseProgram(0);
         }
 
         EMPY_INLINE void Resize(int32_t width, int32_t height)
@@ -107,12 +103,12 @@ namespace Empy
 
             for(auto i = 0; i < 2; i++)
             {
-                glBindTexture(GL_TEXTURE_2D, m_PingPongMaps[i]);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, m_PingPongMaps[i]);
                 glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_Width, 
                 m_Height, 0, GL_RGBA, GL_FLOAT, NULL);
             }
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
         }
 
         EMPY_INLINE uint32_t GetMap()
@@ -122,16 +118,11 @@ namespace Empy
 
         EMPY_INLINE ~BloomShader()
         {
-            glDeleteTextures(2, m_PingPongMaps); 
+            GLState::Get().DeleteTextures(2, m_PingPongMaps); 
             glDeleteFramebuffers(2, m_GausianFBO); 
         }
 
     private:
-        uint32_t u_HorizontalPass = 0u;
-        uint32_t u_BrightnessMap = 0u;        
-        uint32_t u_FrameHeight = 0u;        
-        uint32_t u_FrameWidth = 0u;  
-
         uint32_t m_PingPongMaps[2]; 
         uint32_t m_GausianFBO[2];
 
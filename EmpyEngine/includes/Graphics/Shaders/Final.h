@@ -9,15 +9,13 @@ namespace Empy
         EMPY_INLINE FinalShader(const std::string& filename, int32_t width, int32_t height): 
             Shader(filename) 
         {
-            u_Bloom = glGetUniformLocation(m_ShaderID, "u_bloom");
-            u_Map = glGetUniformLocation(m_ShaderID, "u_map");
             CreateBuffer(width, height);
             m_Quad = CreateQuad2D();
         } 
 
         EMPY_INLINE ~FinalShader()
         {
-            glDeleteTextures(1, &m_Final); 
+            GLState::Get().DeleteTextures(1, &m_Final); 
             glDeleteFramebuffers(1, &m_FBO); 
         }
 
@@ -26,21 +24,21 @@ namespace Empy
             glBindFramebuffer(GL_FRAMEBUFFER, (useFBO) ? 0 : m_FBO);
             glClear(GL_COLOR_BUFFER_BIT); 
             glClearColor(0, 0, 0, 1);
-            glUseProgram(m_ShaderID); 
+            GLState::Get().UseProgram(m_ShaderID); 
 
             // set color map
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, map);
-            glUniform1i(u_Map, 0);
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, map);
+            SetUniform(EMPY_UNIFORM("u_map"), 0);
 
             // set bloom map
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, bloom);
-            glUniform1i(u_Bloom, 1);
+            GLState::Get().ActiveTexture(GL_TEXTURE1);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, bloom);
+            SetUniform(EMPY_UNIFORM("u_bloom"), 1);
 
             // render quad
             m_Quad->Draw(GL_TRIANGLES);
-            glUseProgram(0); 
+            GLState::Get().UseProgram(0); 
 
             // bind default fbo
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -48,10 +46,10 @@ namespace Empy
 
         EMPY_INLINE void Resize(int32_t width, int32_t height)
         {
-            glBindTexture(GL_TEXTURE_2D, m_Final);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Final);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, 
             width, height, 0, GL_RGBA, GL_FLOAT, NULL);            
-            glBindTexture(GL_TEXTURE_2D, 0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
         }
 
         EMPY_INLINE uint32_t GetMap()
@@ -68,7 +66,7 @@ namespace Empy
 
             // create attachment
             glGenTextures(1, &m_Final);
-            glBindTexture(GL_TEXTURE_2D, m_Final);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_Final);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -90,9 +88,6 @@ namespace Empy
         uint32_t m_Final = 0u;
         uint32_t m_FBO = 0u;
 
-        uint32_t u_Bloom = 0u;
-        uint32_t u_Map = 0u;
-
         Quad2D m_Quad;
     }; 
 }
\ No newline at end of file
@@ -7,11 +7,7 @@ namespace Empy
     struct IrradianceShader : Shader 
     { 
         EMPY_INLINE IrradianceShader(const std::string& path): Shader(path) 
-        {
-            u_CubeMap = glGetUniformLocation(m_ShaderID, "u_cubemap");
-            u_View = glGetUniformLocation(m_ShaderID, "u_view");
-            u_Proj = glGetUniformLocation(m_ShaderID, "u_proj");
-        } 
+        {} 
 
         EMPY_INLINE uint32_t Generate(uint32_t skyCubMap, SkyboxMesh& mesh, int32_t size) 
         {            
@@ -32,7 +28,7 @@ namespace Empy
             // generate cube map
             uint32_t irradMap = 0u;
             glGenTextures(1, &irradMap);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, irradMap);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, irradMap);
 
             // init size
             for (uint32_t i = 0; i < 6; ++i) 
@@ -47,13 +43,13 @@ namespace Empy
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-            glUseProgram(m_ShaderID); 
-            glUniformMatrix4fv(u_Proj, 1, GL_FALSE, glm::value_ptr(projection));
+            GLState::Get().UseProgram(m_ShaderID); 
+            SetUniform(EMPY_UNIFORM("u_proj"), projection);
 
             // bind skybox cube map
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, skyCubMap);
-            glUniform1i(u_CubeMap, 0); 
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, skyCubMap);
+            SetUniform(EMPY_UNIFORM("u_cubemap"), 0); 
 
             uint32_t FBO, RBO = 0u;
             glGenFramebuffers(1, &FBO);
@@ -67,7 +63,7 @@ namespace Empy
 
             for (uint32_t i = 0; i < 6; ++i) 
             {
-                glUniformMatrix4fv(u_View, 1, GL_FALSE, glm::value_ptr(views[i]));
+                SetUniform(EMPY_UNIFORM("u_view"), views[i]);
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, irradMap, 0);
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -75,19 +71,14 @@ namespace Empy
             }
 
             // unbind shader, buffer
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glUseProgram(0);
+            GLState::Get().UseProgram(0);
 
             // delete fbo & rbo
             glDeleteRenderbuffers(1, &RBO);
             glDeleteFramebuffers(1, &FBO);
             return irradMap;
         }
-
-    private:
-        uint32_t u_CubeMap = 0u;
-        uint32_t u_View = 0u;
-        uint32_t u_Proj = 0u;
     }; 
 }
\ No newline at end of file
@@ -1,216 +1,136 @@
 #pragma once
 #include "Shader.h"
+#include "../Utilities/Clusters.h"
+#include "../Buffers/Instance.h"
 
 namespace Empy
 {
     struct PbrShader : Shader 
     {        
         EMPY_INLINE PbrShader(const std::string& filename): Shader(filename) 
-        {
-            u_NbrDirectLight = glGetUniformLocation(m_ShaderID, "u_nbrDirectLight");
-            u_NbrPointLight = glGetUniformLocation(m_ShaderID, "u_nbrPointLight");
-            u_NbrSpotLight = glGetUniformLocation(m_ShaderID, "u_nbrSpotLight");
-
-            u_PrefilMap = glGetUniformLocation(m_ShaderID, "u_prefilMap");            
-            u_IrradMap = glGetUniformLocation(m_ShaderID, "u_irradMap");
-            u_BrdfMap = glGetUniformLocation(m_ShaderID, "u_brdfMap");
-
-            u_LightSpace = glGetUniformLocation(m_ShaderID, "u_lightSpace");
-            u_DepthMap = glGetUniformLocation(m_ShaderID, "u_depthMap");
-
-            u_HasJoints = glGetUniformLocation(m_ShaderID, "u_hasJoints");
-
-            u_ViewPos = glGetUniformLocation(m_ShaderID, "u_viewPos");
-            u_Model = glGetUniformLocation(m_ShaderID, "u_model");
-            u_View = glGetUniformLocation(m_ShaderID, "u_view");
-            u_Proj = glGetUniformLocation(m_ShaderID, "u_proj");
-            
-            u_Material.Initialize(m_ShaderID);
-        } 
+        {} 
 
         EMPY_INLINE void SetEnvMaps(uint32_t irrad, uint32_t prefil, uint32_t brdf, uint32_t depthMap)
         {
-            glUseProgram(m_ShaderID);
+            GLState::Get().UseProgram(m_ShaderID);
             
             // irradiance map
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, irrad);
-            glUniform1i(u_IrradMap, 0);
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, irrad);
+            SetUniform(EMPY_UNIFORM("u_irradMap"), 0);
 
             // prefiltered map
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, prefil);
-            glUniform1i(u_PrefilMap, 1);
+            GLState::Get().ActiveTexture(GL_TEXTURE1);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, prefil);
+            SetUniform(EMPY_UNIFORM("u_prefilMap"), 1);
 
             // BRDF Map
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, brdf);
-            glUniform1i(u_BrdfMap, 2);
+            GLState::Get().ActiveTexture(GL_TEXTURE2);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, brdf);
+            SetUniform(EMPY_UNIFORM("u_brdfMap"), 2);
 
             // Depth Map
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, depthMap);
-            glUniform1i(u_DepthMap, 3);
+            GLState::Get().ActiveTexture(GL_TEXTURE3);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, depthMap);
+            SetUniform(EMPY_UNIFORM("u_depthMap"), 3);
         }
 
         EMPY_INLINE void SetDirectLight(DirectLight& light, Transform3D& transform, int32_t index) 
         {
-            std::string intensity = "u_directLights[" + std::to_string(index) + "].Intensity";
-            std::string direction = "u_directLights[" + std::to_string(index) + "].Direction";
-            std::string radiance = "u_directLights[" + std::to_string(index) + "].Radiance";
-
-            uint32_t u_intensity = glGetUniformLocation(m_ShaderID, intensity.c_str());
-            uint32_t u_direction = glGetUniformLocation(m_ShaderID, direction.c_str());
-            uint32_t u_radiance = glGetUniformLocation(m_ShaderID, radiance.c_str());
-
-            glUniform3fv(u_direction, 1, &transform.Rotation.x);
-            glUniform3fv(u_radiance, 1, &light.Radiance.x);
-            glUniform1f(u_intensity, light.Intensity);
+            SetUniform(EMPY_UNIFORM("u_directLights[].Direction"), transform.Rotation, index);
+            SetUniform(EMPY_UNIFORM("u_directLights[].Radiance"), light.Radiance, index);
+            SetUniform(EMPY_UNIFORM("u_directLights[].Intensity"), light.Intensity, index);
         }
 
-        EMPY_INLINE void SetPointLight(PointLight& light, Transform3D& transform, int32_t index) 
+        // point and spot lights come from the cluster buffers
+        EMPY_INLINE void SetClusters(LightClusters& clusters, const glm::vec2& tile, int32_t unit) 
         {
-            std::string intensity = "u_pointLights[" + std::to_string(index) + "].Intensity";
-            std::string radiance = "u_pointLights[" + std::to_string(index) + "].Radiance";
-            std::string position = "u_pointLights[" + std::to_string(index) + "].Position";
-
-            uint32_t u_intensity = glGetUniformLocation(m_ShaderID, intensity.c_str());
-            uint32_t u_radiance = glGetUniformLocation(m_ShaderID, radiance.c_str());
-            uint32_t u_position = glGetUniformLocation(m_ShaderID, position.c_str());
-
-            glUniform3fv(u_position, 1, &transform.Translate.x);
-            glUniform3fv(u_radiance, 1, &light.Radiance.x);
-            glUniform1f(u_intensity, light.Intensity);
+            clusters.Bind(unit);
+            SetUniform(EMPY_UNIFORM("u_lightData"), unit);
+            SetUniform(EMPY_UNIFORM("u_clusterData"), unit + 1);
+            SetUniform(EMPY_UNIFORM("u_lightIndices"), unit + 2);
+
+            SetUniform(EMPY_UNIFORM("u_clusterDepth"), clusters.DepthRange());
+            SetUniform(EMPY_UNIFORM("u_clusterSlice"), clusters.SliceScale());
+            SetUniform(EMPY_UNIFORM("u_clusterTile"), tile);
         }
 
-        EMPY_INLINE void SetSpotLight(SpotLight& light, Transform3D& transform, int32_t index) 
+        // one upload for the changed range of the rig
+        EMPY_INLINE void SetJoints(std::vector<glm::mat4>& joints) 
         {
-            std::string intensity = "u_spotLights[" + std::to_string(index) + "].Intensity";
-            std::string direction = "u_spotLights[" + std::to_string(index) + "].Direction";
-            std::string radiance = "u_spotLights[" + std::to_string(index) + "].Radiance";
-            std::string position = "u_spotLights[" + std::to_string(index) + "].Position";
-            std::string falloff = "u_spotLights[" + std::to_string(index) + "].FallOff";
-            std::string cutoff = "u_spotLights[" + std::to_string(index) + "].CutOff";
-
-            uint32_t u_intensity = glGetUniformLocation(m_ShaderID, intensity.c_str());
-            uint32_t u_direction = glGetUniformLocation(m_ShaderID, direction.c_str());
-            uint32_t u_radiance = glGetUniformLocation(m_ShaderID, radiance.c_str());
-            uint32_t u_position = glGetUniformLocation(m_ShaderID, position.c_str());
-            uint32_t u_falloff = glGetUniformLocation(m_ShaderID, falloff.c_str());
-            uint32_t u_cutoff = glGetUniformLocation(m_ShaderID, cutoff.c_str());
-
-            glUniform3fv(u_direction, 1, &transform.Rotation.x);
-            glUniform3fv(u_position, 1, &transform.Translate.x);
-            glUniform3fv(u_radiance, 1, &light.Radiance.x);
-
-            glUniform1f(u_falloff, glm::radians(light.FallOff));
-            glUniform1f(u_cutoff, glm::radians(light.CutOff));
-            glUniform1f(u_intensity, light.Intensity);
+            auto count = static_cast<uint32_t>(std::min<size_t>(joints.size(), 100u));
+            SetUniforms(EMPY_UNIFORM("u_joints[]"), joints.data(), count);
         }
 
-        
-        EMPY_INLINE void SetJoints(std::vector<glm::mat4>& joints) 
+        // world matrices of one page of the frame batches
+        EMPY_INLINE void SetInstances(InstanceBuffer& instances, int32_t unit, uint32_t page = 0u)
         {
-            for (size_t i = 0; i < joints.size() && i < 100; ++i) 
-            {
-                std::string uniform = "u_joints[" + std::to_string(i) + "]";
-                uint32_t u_joint = glGetUniformLocation(m_ShaderID, uniform.c_str());
-                glUniformMatrix4fv(u_joint, 1, GL_FALSE, glm::value_ptr(joints[i]));
-            }
+            instances.Bind(unit, page);
+            SetUniform(EMPY_UNIFORM("u_instances"), unit);
         }
 
-        EMPY_INLINE void Draw(Model3D& model, Material& mtl, Transform3D& transform)
+        // draws count instances starting at first in the instance buffer
+        EMPY_INLINE void Draw(Model3D& model, Material& mtl, int32_t first, uint32_t count)
         {
-            // set transform
-            glUniformMatrix4fv(u_Model, 1, GL_FALSE, glm::value_ptr(transform.Matrix()));  
-            glUniform1i(u_HasJoints, model->HasJoints()); 
+            // set transforms
+            SetUniform(EMPY_UNIFORM("u_instanceBase"), first);  
+            SetUniform(EMPY_UNIFORM("u_hasJoints"), static_cast<int32_t>(model->HasJoints())); 
             // set mtl
             SetMaterial(mtl, 4);
             // render mesh
-            model->Draw(GL_TRIANGLES);        
+            model->Draw(GL_TRIANGLES, count);        
         }
 
         EMPY_INLINE void SetCamera(Camera3D& camera, Transform3D& transform, float ratio) 
         {
-            glUniformMatrix4fv(u_Proj, 1, GL_FALSE, glm::value_ptr(camera.Projection(ratio)));
-            glUniformMatrix4fv(u_View, 1, GL_FALSE, glm::value_ptr(camera.View(transform)));
-            glUniform3fv(u_ViewPos, 1, &transform.Translate.x);
+            SetUniform(EMPY_UNIFORM("u_proj"), camera.Projection(ratio));
+            SetUniform(EMPY_UNIFORM("u_view"), camera.View(transform));
+            SetUniform(EMPY_UNIFORM("u_viewPos"), transform.Translate);
         } 
 
         EMPY_INLINE void SetLightSpaceMatrix(const glm::mat4& lightSpaceMtx)
         {
             // set view projection matrix
-            glUniformMatrix4fv(u_LightSpace, 1, GL_FALSE, glm::value_ptr(lightSpaceMtx));  
+            SetUniform(EMPY_UNIFORM("u_lightSpace"), lightSpaceMtx);  
         }
 
         EMPY_INLINE void SetDirectLightCount(int32_t count)
         {
-            glUniform1i(u_NbrDirectLight, count);
-        }
-
-        EMPY_INLINE void SetPointLightCount(int32_t count)
-        {
-            glUniform1i(u_NbrPointLight, count);
-        }
-
-        EMPY_INLINE void SetSpotLightCount(int32_t count)
-        {
-            glUniform1i(u_NbrSpotLight, count);
+            SetUniform(EMPY_UNIFORM("u_nbrDirectLight"), count);
         }
 
 private:
         EMPY_INLINE void UseMap(uint32_t map, uint32_t uniform, int32_t unit) 
         { 
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(GL_TEXTURE_2D, map);
-            glUniform1i(uniform, unit); 
+            GLState::Get().ActiveTexture(GL_TEXTURE0 + unit);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, map);
+            SetUniform(uniform, unit); 
         }
 
         EMPY_INLINE void SetMaterial(Material& mtl, int32_t unit) 
 		{
 			// set usability
-			glUniform1i(u_Material.UseRoughnessMap, mtl.RoughnessMap);
-			glUniform1i(u_Material.UseOcclusionMap, mtl.OcclusionMap);
-			glUniform1i(u_Material.UseEmissiveMap, mtl.EmissiveMap);
-			glUniform1i(u_Material.UseMetallicMap, mtl.MetallicMap);
-			glUniform1i(u_Material.UseAlbedoMap, mtl.AlbedoMap);
-			glUniform1i(u_Material.UseNormalMap, mtl.NormalMap);
+			SetUniform(EMPY_UNIFORM("u_material.UseRoughnessMap"), static_cast<int32_t>(mtl.RoughnessMap != 0u));
+			SetUniform(EMPY_UNIFORM("u_material.UseOcclusionMap"), static_cast<int32_t>(mtl.OcclusionMap != 0u));
+			SetUniform(EMPY_UNIFORM("u_material.UseEmissiveMap"), static_cast<int32_t>(mtl.EmissiveMap != 0u));
+			SetUniform(EMPY_UNIFORM("u_material.UseMetallicMap"), static_cast<int32_t>(mtl.MetallicMap != 0u));
+			SetUniform(EMPY_UNIFORM("u_material.UseAlbedoMap"), static_cast<int32_t>(mtl.AlbedoMap != 0u));
+			SetUniform(EMPY_UNIFORM("u_material.UseNormalMap"), static_cast<int32_t>(mtl.NormalMap != 0u));
 
 			// set mtl maps
-            UseMap(mtl.RoughnessMap, u_Material.RoughnessMap, unit++);
-            UseMap(mtl.OcclusionMap, u_Material.OcclusionMap, unit++);
-            UseMap(mtl.EmissiveMap, u_Material.EmissiveMap, unit++);
-            UseMap(mtl.MetallicMap, u_Material.MetallicMap, unit++);
-            UseMap(mtl.AlbedoMap, u_Material.AlbedoMap, unit++);
-            UseMap(mtl.NormalMap, u_Material.NormalMap, unit++);
+            UseMap(mtl.RoughnessMap, EMPY_UNIFORM("u_material.RoughnessMap"), unit++);
+            UseMap(mtl.OcclusionMap, EMPY_UNIFORM("u_material.OcclusionMap"), unit++);
+            UseMap(mtl.EmissiveMap, EMPY_UNIFORM("u_material.EmissiveMap"), unit++);
+            UseMap(mtl.MetallicMap, EMPY_UNIFORM("u_material.MetallicMap"), unit++);
+            UseMap(mtl.AlbedoMap, EMPY_UNIFORM("u_material.AlbedoMap"), unit++);
+            UseMap(mtl.NormalMap, EMPY_UNIFORM("u_material.NormalMap"), unit++);
 
 			// set properties
-			glUniform3fv(u_Material.Emissive, 1, &mtl.Emissive.x);
-            glUniform3fv(u_Material.Albedo, 1, &mtl.Albedo.x);
-            glUniform1f(u_Material.Roughness, mtl.Roughness);
-            glUniform1f(u_Material.Occlusion, mtl.Occlusion);
-            glUniform1f(u_Material.Metallic, mtl.Metallic);
+			SetUniform(EMPY_UNIFORM("u_material.Emissive"), mtl.Emissive);
+            SetUniform(EMPY_UNIFORM("u_material.Albedo"), mtl.Albedo);
+            SetUniform(EMPY_UNIFORM("u_material.Roughness"), mtl.Roughness);
+            SetUniform(EMPY_UNIFORM("u_material.Occlusion"), mtl.Occlusion);
+            SetUniform(EMPY_UNIFORM("u_material.Metallic"), mtl.Metallic);
 		}
-        
-    private:     
-        uint32_t u_HasJoints = 0u;
-
-        //-- light
-        uint32_t u_NbrDirectLight = 0u;
-        uint32_t u_NbrPointLight = 0u;
-        uint32_t u_NbrSpotLight = 0u;        
-        uint32_t u_LightSpace = 0u;
-        // --
-        MaterialUniform u_Material;
-        //--
-        uint32_t u_PrefilMap = 0u;
-        uint32_t u_DepthMap = 0u;
-        uint32_t u_IrradMap = 0u;
-        uint32_t u_BrdfMap = 0u;
-        //--
-        uint32_t u_ViewPos = 0u;
-        uint32_t u_Model = 0u;
-        uint32_t u_View = 0u;
-        uint32_t u_Proj = 0u;
     };   
 }
\ No newline at end of file
@@ -1,32 +1,323 @@
 #pragma once
 #include "../Utilities/Data.h"
 #include "../Textures/Texture.h"
+#include <cstring>
 
 namespace Empy
 {
+    // fnv-1a of a uniform name, array indices written as "[]"
+    constexpr uint32_t UniformHash(const char* name) 
+    {
+        uint32_t hash = 2166136261u;
+        while(*name) { hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u; }
+        return hash;
+    }
+
+    // hashed at compile time
+    #define EMPY_UNIFORM(name) std::integral_constant<uint32_t, Empy::UniformHash(name)>::value
+
+    // active uniform, one entry per array element
+    struct ShaderUniform 
+    {
+        uint32_t Hash = 0u;
+        uint32_t Index = 0u;
+        int32_t Location = -1;
+        // bytes of one element
+        uint32_t Bytes = 0u;
+        // elements from this one to the array end
+        uint32_t Count = 0u;
+        // last uploaded value in the cache
+        uint32_t Offset = 0u;
+        uint32_t Type = 0u;
+    };
+
     struct Shader 
     {
         EMPY_INLINE Shader(const std::string& filename) 
         {
             m_ShaderID = Load(filename);
+            Reflect();
+        }
+
+        // typed setters, program must be bound, unchanged values are skipped
+
+        EMPY_INLINE void SetUniform(uint32_t name, int32_t value, uint32_t index = 0u) 
+        {
+            if(auto uniform = Changed(name, index, &value, sizeof(value))) 
+            { 
+                glUniform1i(uniform->Location, value); 
+            }
+        }
+
+        EMPY_INLINE void SetUniform(uint32_t name, float value, uint32_t index = 0u) 
+        {
+            if(auto uniform = Changed(name, index, &value, sizeof(value))) 
+            { 
+                glUniform1f(uniform->Location, value); 
+            }
+        }
+
+        EMPY_INLINE void SetUniform(uint32_t name, const glm::vec2& value, uint32_t index = 0u) 
+        {
+            if(auto uniform = Changed(name, index, &value, sizeof(value))) 
+            { 
+                glUniform2fv(uniform->Location, 1, &value.x); 
+            }
+        }
+
+        EMPY_INLINE void SetUniform(uint32_t name, const glm::vec3& value, uint32_t index = 0u) 
+        {
+            if(auto uniform = Changed(name, index, &value, sizeof(value))) 
+            { 
+                glUniform3fv(uniform->Location, 1, &value.x); 
+            }
+        }
+
+        EMPY_INLINE void SetUniform(uint32_t name, const glm::mat4& value, uint32_t index = 0u) 
+        {
+            if(auto uniform = Changed(name, index, &value, sizeof(value))) 
+            { 
+                glUniformMatrix4fv(uniform->Location, 1, GL_FALSE, glm::value_ptr(value)); 
+            }
+        }
+
+        // uploads only the changed range of a matrix array
+        EMPY_INLINE void SetUniforms(uint32_t name, const glm::mat4* values, uint32_t count) 
+        {
+            auto uniform = Find(name, 0u);
+            if(!uniform || uniform->Bytes != sizeof(glm::mat4)) { return; }
+            count = std::min(count, uniform->Count);
+
+            auto cache = reinterpret_cast<glm::mat4*>(m_Values.data() + uniform->Offset);
+            uint32_t first = 0u, last = count;
+            while(first < count && cache[first] == values[first]) { first++; }
+            GLState::Get().CountUniform(first == count);
+            if(first == count) { return; }
+            while(last > first && cache[last - 1u] == values[last - 1u]) { last--; }
+
+            std::copy(values + first, values + last, cache + first);
+            auto location = Find(name, first)->Location;
+            glUniformMatrix4fv(location, last - first, GL_FALSE, glm::value_ptr(values[first]));
+        }
+
+        // binds a named uniform block to a buffer binding point
+        EMPY_INLINE void SetBlockBinding(uint32_t name, uint32_t binding) 
+        {
+            auto itr = m_Blocks.find(name);
+            if(itr != m_Blocks.end()) { glUniformBlockBinding(m_ShaderID, itr->second, binding); }
+        }
+
+        EMPY_INLINE bool HasUniform(uint32_t name, uint32_t index = 0u) 
+        {
+            return Find(name, index) != nullptr;
         }
 
         EMPY_INLINE virtual ~Shader() 
         {
-            glDeleteProgram(m_ShaderID);
+            GLState::Get().DeleteProgram(m_ShaderID);
         }
 
         EMPY_INLINE void Unbind() 
         { 
-            glUseProgram(0); 
+            GLState::Get().UseProgram(0); 
         } 
 
         EMPY_INLINE void Bind() 
         { 
-            glUseProgram(m_ShaderID); 
+            GLState::Get().UseProgram(m_ShaderID); 
         }  
     
     private:
+        // entry of name[index], null if the uniform is inactive
+        EMPY_INLINE ShaderUniform* Find(uint32_t name, uint32_t index) 
+        {
+            if(m_Uniforms.empty()) { return nullptr; }
+            auto mask = static_cast<uint32_t>(m_Uniforms.size() - 1u);
+            for(auto slot = Slot(name, index) & mask;; slot = (slot + 1u) & mask)
+            {
+                auto& uniform = m_Uniforms[slot];
+                if(uniform.Location < 0) { return nullptr; }
+                if(uniform.Hash == name && uniform.Index == index) { return &uniform; }
+            }
+        }
+
+        // entry to upload to, null if inactive or unchanged
+        EMPY_INLINE ShaderUniform* Changed(uint32_t name, uint32_t index, const void* value, uint32_t bytes) 
+        {
+            auto uniform = Find(name, index);
+            if(!uniform) { return nullptr; }
+            EMPY_ASSERT(uniform->Bytes == bytes);
+
+            auto cache = m_Values.data() + uniform->Offset;
+            bool skipped = std::memcmp(cache, value, bytes) == 0;
+            GLState::Get().CountUniform(skipped);
+            if(skipped) { return nullptr; }
+            std::memcpy(cache, value, bytes);
+            return uniform;
+        }
+
+        EMPY_INLINE static uint32_t Slot(uint32_t name, uint32_t index) 
+        {
+            return name ^ (index * 0x9E3779B1u);
+        }
+
+        // cache bytes of a gl 3.3 uniform type, zero for types not cached
+        EMPY_INLINE static uint32_t TypeBytes(uint32_t type) 
+        {
+            switch(type)
+            {
+                case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: return 4u;
+                case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 8u;
+                case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 12u;
+                case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: return 16u;
+                case GL_FLOAT_MAT2: return 16u;
+                case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: return 24u;
+                case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: return 32u;
+                case GL_FLOAT_MAT3: return 36u;
+                case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: return 48u;
+                case GL_FLOAT_MAT4: return 64u;
+                default: return IsSamplerType(type) ? 4u : 0u;
+            }
+        }
+
+        EMPY_INLINE static bool IsFloatType(uint32_t type) 
+        {
+            switch(type)
+            {
+                case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+                case GL_FLOAT_MAT2: case GL_FLOAT_MAT3: case GL_FLOAT_MAT4:
+                case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT3x2:
+                case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x2: case GL_FLOAT_MAT4x3: return true;
+                default: return false;
+            }
+        }
+
+        // samplers hold a texture unit
+        EMPY_INLINE static bool IsSamplerType(uint32_t type) 
+        {
+            switch(type)
+            {
+                case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+                case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+                case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: 
+                case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+                case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+                case GL_SAMPLER_BUFFER: case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW:
+                case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+                case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY:
+                case GL_INT_SAMPLER_2D_MULTISAMPLE: case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+                case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_RECT:
+                case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: 
+                case GL_UNSIGNED_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_CUBE:
+                case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+                case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+                case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_RECT: return true;
+                default: return false;
+            }
+        }
+
+        // active uniforms and blocks into the hashed table, cache holds current values
+        EMPY_INLINE void Reflect() 
+        {
+            if(!m_ShaderID) { return; }
+
+            int32_t count = 0, length = 0;
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+            std::vector<char> buffer(std::max(length, 1));
+
+            std::vector<std::pair<std::string, ShaderUniform>> entries;
+            for(int32_t i = 0; i < count; i++)
+            {
+                int32_t size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(m_ShaderID, i, length, nullptr, &size, &type, buffer.data());
+                std::string name(buffer.data());
+
+                // reading back an unknown type could overrun its cache slot
+                if(TypeBytes(type) == 0u)
+                {
+                    EMPY_WARN("uniform '{}' has unsupported type {:#x}, not cached", name, type);
+                    continue;
+                }
+
+                // "a[2].b" -> "a[].b" index 2, "a[0]" of size n -> n elements
+                uint32_t index = 0u;
+                auto open = name.find('[');
+                std::string pattern = name;
+                if(open != std::string::npos)
+                {
+                    auto close = name.find(']', open);
+                    index = static_cast<uint32_t>(std::stoul(name.substr(open + 1u, close - open - 1u)));
+                    pattern = name.substr(0u, open + 1u) + name.substr(close);
+                }
+                else if(size > 1)
+                {
+                    // some drivers drop the "[0]" of plain arrays
+                    open = name.size();
+                    pattern = name + "[]";
+                }
+
+                for(int32_t k = 0; k < size; k++)
+                {
+                    auto element = (size > 1) ? name.substr(0u, open) + "[" + std::to_string(k) + "]" : name;
+                    ShaderUniform uniform;
+                    uniform.Hash = UniformHash(pattern.c_str());
+                    uniform.Index = index + k;
+                    uniform.Location = glGetUniformLocation(m_ShaderID, element.c_str());
+                    uniform.Bytes = TypeBytes(type);
+                    uniform.Count = static_cast<uint32_t>(size - k);
+                    uniform.Type = type;
+                    if(uniform.Location >= 0) { entries.emplace_back(element, uniform); }
+                }
+            }
+
+            // power of two, at most half full
+            size_t capacity = 16u;
+            while(capacity < entries.size() * 2u) { capacity *= 2u; }
+            m_Uniforms.assign(capacity, ShaderUniform());
+            auto mask = static_cast<uint32_t>(capacity - 1u);
+
+            for(auto& [element, uniform] : entries)
+            {
+                // array elements share one contiguous cache range
+                uniform.Offset = static_cast<uint32_t>(m_Values.size());
+                m_Values.resize(m_Values.size() + uniform.Bytes);
+
+                // cache starts at the linked defaults
+                auto cache = m_Values.data() + uniform.Offset;
+                if(IsFloatType(uniform.Type))
+                {
+                    glGetUniformfv(m_ShaderID, uniform.Location, reinterpret_cast<float*>(cache));
+                }
+                else
+                {
+                    glGetUniformiv(m_ShaderID, uniform.Location, reinterpret_cast<int32_t*>(cache));
+                }
+
+                auto slot = Slot(uniform.Hash, uniform.Index) & mask;
+                while(m_Uniforms[slot].Location >= 0) 
+                {
+                    if(m_Uniforms[slot].Hash == uniform.Hash && m_Uniforms[slot].Index == uniform.Index)
+                    {
+                        EMPY_WARN("uniform hash collision: {}", element);
+                    }
+                    slot = (slot + 1u) & mask; 
+                }
+                m_Uniforms[slot] = uniform;
+            }
+
+            int32_t blocks = 0;
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_BLOCKS, &blocks);
+            glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &length);
+            buffer.resize(std::max(length, 1));
+            for(int32_t i = 0; i < blocks; i++)
+            {
+                glGetActiveUniformBlockName(m_ShaderID, i, length, nullptr, buffer.data());
+                m_Blocks[UniformHash(buffer.data())] = static_cast<uint32_t>(i);
+            }
+        }
+
         EMPY_INLINE uint32_t Build(const char* src, uint32_t type) 
         {
             uint32_t shaderID = glCreateShader(type);
@@ -61,7 +352,7 @@ namespace Empy
             if (!status) {
                 glGetProgramInfoLog(programID, 512, NULL, error);
                 throw std::runtime_error(error);
-                glDeleteProgram(programID);
+                GLState::Get().DeleteProgram(programID);
             }
 
             glDeleteShader(vert);
@@ -120,5 +411,10 @@ namespace Empy
                       
     protected:
         uint32_t m_ShaderID = 0u;
+
+    private:
+        std::unordered_map<uint32_t, uint32_t> m_Blocks;
+        std::vector<ShaderUniform> m_Uniforms;
+        std::vector<uint8_t> m_Values;
     };    
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "Shader.h"
+#include "../Buffers/Instance.h"
 
 namespace Empy
 {
@@ -7,12 +8,9 @@ namespace Empy
     { 
         EMPY_INLINE ShadowShader(const std::string& path): Shader(path) 
         {
-            u_LightSpace = glGetUniformLocation(m_ShaderID, "u_lightSpace");
-            u_Model = glGetUniformLocation(m_ShaderID, "u_model");            
-
             // create depth texture
             glGenTextures(1, &m_DepthMap);
-            glBindTexture(GL_TEXTURE_2D, m_DepthMap);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_DepthMap);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 
             MapSize, MapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
 
@@ -43,22 +41,28 @@ namespace Empy
             glBindFramebuffer(GL_FRAMEBUFFER, 0);      
         } 
 
-        EMPY_INLINE void Draw(Model3D& model, Transform3D& transform)
+        EMPY_INLINE void SetInstances(InstanceBuffer& instances, int32_t unit, uint32_t page = 0u)
         {
-            glUniformMatrix4fv(u_Model, 1, GL_FALSE, glm::value_ptr(transform.Matrix()));            
+            instances.Bind(unit, page);
+            SetUniform(EMPY_UNIFORM("u_instances"), unit);
+        }
+
+        // draws count instances starting at first in the instance buffer
+        EMPY_INLINE void Draw(Model3D& model, int32_t first, uint32_t count)
+        {
+            SetUniform(EMPY_UNIFORM("u_instanceBase"), first);            
             glCullFace(GL_FRONT);
-            model->Draw(GL_TRIANGLES);
+            model->Draw(GL_TRIANGLES, count);
             glCullFace(GL_BACK);
         }
 
         EMPY_INLINE void BeginFrame(const glm::mat4& lightSpaceMtx)
         {
             // bind shadow shader
-            glUseProgram(m_ShaderID);
+            GLState::Get().UseProgram(m_ShaderID);
 
             // set view projection matrix
-            glUniformMatrix4fv(u_LightSpace, 1, GL_FALSE, 
-            glm::value_ptr(lightSpaceMtx));  
+            SetUniform(EMPY_UNIFORM("u_lightSpace"), lightSpaceMtx);  
 
             // bind target frame buffer
             glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBuffer);   
@@ -78,21 +82,18 @@ namespace Empy
         {
             glDisable(GL_DEPTH_TEST); 
             glBindFramebuffer(GL_FRAMEBUFFER, 0);  
-            glUseProgram(0);
+            GLState::Get().UseProgram(0);
         }
 
         EMPY_INLINE ~ShadowShader()
         {
             glDeleteFramebuffers(1, &m_FrameBuffer); 
-            glDeleteTextures(1, &m_DepthMap); 
+            GLState::Get().DeleteTextures(1, &m_DepthMap); 
         }
 
     private:
         uint32_t m_FrameBuffer = 0u;
         uint32_t m_DepthMap = 0u;
         int32_t MapSize = 1024;
-
-        uint32_t u_LightSpace = 0u;
-        uint32_t u_Model = 0u;        
     }; 
 }
\ No newline at end of file
@@ -7,11 +7,7 @@ namespace Empy
     struct SkyMapShader : Shader 
     { 
         EMPY_INLINE SkyMapShader(const std::string& path): Shader(path) 
-        {
-            u_View = glGetUniformLocation(m_ShaderID, "u_view");
-            u_Proj = glGetUniformLocation(m_ShaderID, "u_proj");
-            u_Map = glGetUniformLocation(m_ShaderID, "u_map");
-        } 
+        {} 
 
         EMPY_INLINE uint32_t Generate(Texture2D& texture, SkyboxMesh& mesh, int32_t size) 
         {
@@ -30,18 +26,20 @@ namespace Empy
             glm::mat4 proj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
 
             // bind shader
-            glUseProgram(m_ShaderID); 
+            GLState::Get().UseProgram(m_ShaderID); 
 
             // set projection matrix
-            glUniformMatrix4fv(u_Proj, 1, GL_FALSE, glm::value_ptr(proj));
+            SetUniform(EMPY_UNIFORM("u_proj"), proj);
 
             // set texture source
-            texture.Use(u_Map, 0);
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            texture.Bind();
+            SetUniform(EMPY_UNIFORM("u_map"), 0);
 
             // generate cube map
             uint32_t cubeMap = 0u;
             glGenTextures(1, &cubeMap);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, cubeMap);
 
             // set cube map faces size
             for (uint32_t i = 0; i < 6; ++i) 
@@ -73,7 +71,7 @@ namespace Empy
             for (uint32_t i = 0; i < 6; ++i) 
             {   
                 // set current face view matrix
-                glUniformMatrix4fv(u_View, 1, GL_FALSE, glm::value_ptr(views[i]));
+                SetUniform(EMPY_UNIFORM("u_view"), views[i]);
 
                 // set cube map current face 
                 glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 
@@ -90,19 +88,14 @@ namespace Empy
             glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
             // unbind shader, buffer
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            GLState::Get().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glUseProgram(0);
+            GLState::Get().UseProgram(0);
 
             // delete buffers 
             glDeleteRenderbuffers(1, &RBO);
             glDeleteFramebuffers(1, &FBO);
             return cubeMap;
         }
-
-    private:
-        uint32_t u_View = 0u;
-        uint32_t u_Proj = 0u;
-        uint32_t u_Map = 0u;
     }; 
 }
\ No newline at end of file
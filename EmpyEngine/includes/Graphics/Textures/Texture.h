@@ -1,5 +1,6 @@
 #pragma once
 #include "Common/Core.h"
+#include "../Utilities/State.h"
 #include <stb_image.h>
 
 namespace Empy
@@ -12,7 +13,7 @@ namespace Empy
         }
 
         EMPY_INLINE Texture2D(const std::string& path) { Load(path); }
-        EMPY_INLINE ~Texture2D() { glDeleteTextures(1, &m_ID); }
+        EMPY_INLINE ~Texture2D() { GLState::Get().DeleteTextures(1, &m_ID); }
         EMPY_INLINE Texture2D() = default;
 
         EMPY_INLINE bool Load(const std::string& path, bool isHDR = false, bool flipY = true) 
@@ -41,7 +42,7 @@ namespace Empy
 
             // create texture
             glGenTextures(1, &m_ID);
-            glBindTexture(GL_TEXTURE_2D, m_ID);            
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_ID);            
 
             // load texture to gpu
             if (isHDR) 
@@ -63,7 +64,7 @@ namespace Empy
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 			glGenerateMipmap(GL_TEXTURE_2D);      
 
-            glBindTexture(GL_TEXTURE_2D, 0);  
+            GLState::Get().BindTexture(GL_TEXTURE_2D, 0);  
             return true;     
         } 
       
@@ -72,13 +73,13 @@ namespace Empy
         EMPY_INLINE int32_t Width() const { return m_Width; }
         EMPY_INLINE uint32_t ID() const { return m_ID; }
 
-        EMPY_INLINE void Bind() { glBindTexture(GL_TEXTURE_2D, m_ID); }
-        EMPY_INLINE void Unbind() { glBindTexture(GL_TEXTURE_2D, 0); }
+        EMPY_INLINE void Bind() { GLState::Get().BindTexture(GL_TEXTURE_2D, m_ID); }
+        EMPY_INLINE void Unbind() { GLState::Get().BindTexture(GL_TEXTURE_2D, 0); }
 
         EMPY_INLINE void Use(uint32_t uniform, int32_t unit) 
         { 
-            glActiveTexture(GL_TEXTURE0 + unit);
-            glBindTexture(GL_TEXTURE_2D, m_ID);
+            GLState::Get().ActiveTexture(GL_TEXTURE0 + unit);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, m_ID);
             glUniform1i(uniform, unit); 
         }
 
@@ -0,0 +1,304 @@
+#pragma once
+#include "Data.h"
+#include "State.h"
+#include "Common/Jobs.h"
+
+namespace Empy
+{
+    // point or spot light as four texels of the light buffer
+    struct ClusterLight
+    {
+        // xyz position, w intensity
+        glm::vec4 Position = glm::vec4(0.0f);
+        // rgb radiance, w culling range
+        glm::vec4 Radiance = glm::vec4(0.0f);
+        // xyz direction, w one for spot lights
+        glm::vec4 Direction = glm::vec4(0.0f);
+        // x falloff, y cutoff
+        glm::vec4 Cone = glm::vec4(0.0f);
+    };
+
+    // lights of one depth slice, structure of arrays for the cluster tests
+    struct ClusterSlice
+    {
+        std::vector<uint32_t> Indices;
+        std::vector<uint32_t> Lights;
+        std::vector<uint8_t> Hits;
+        std::vector<float> X, Y, Z, R2;
+    };
+
+    // bins point and spot lights into view frustum froxels
+    struct LightClusters
+    {
+        // must match the constants of pbr.glsl
+        static constexpr uint32_t GRID_X = 16u;
+        static constexpr uint32_t GRID_Y = 9u;
+        static constexpr uint32_t GRID_Z = 24u;
+        static constexpr uint32_t TILES = GRID_X * GRID_Y;
+        static constexpr uint32_t COUNT = TILES * GRID_Z;
+        static constexpr uint32_t MAX_PER_CLUSTER = 256u;
+        // radiance under which a light no longer counts
+        static constexpr float THRESHOLD = 0.01f;
+
+        EMPY_INLINE LightClusters()
+        {
+            glGenBuffers(3, m_Buffers);
+            glGenTextures(3, m_Textures);
+
+            GLenum formats[] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+            for(uint32_t i = 0u; i < 3u; i++)
+            {
+                glBindBuffer(GL_TEXTURE_BUFFER, m_Buffers[i]);
+                glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+                GLState::Get().BindTexture(GL_TEXTURE_BUFFER, m_Textures[i]);
+                glTexBuffer(GL_TEXTURE_BUFFER, formats[i], m_Buffers[i]);
+            }
+
+            GLState::Get().BindTexture(GL_TEXTURE_BUFFER, 0);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &m_MaxTexels);
+
+            m_Grid.resize(COUNT);
+            m_Min.resize(COUNT);
+            m_Max.resize(COUNT);
+            m_Slices.resize(GRID_Z);
+        }
+
+        EMPY_INLINE ~LightClusters()
+        {
+            GLState::Get().DeleteTextures(3, m_Textures);
+            glDeleteBuffers(3, m_Buffers);
+        }
+
+        // bins lights on the job system and uploads the buffers
+        EMPY_INLINE void Build(const glm::mat4& view, const glm::mat4& proj, float nearPlane, float farPlane,
+            const std::vector<std::pair<PointLight, Transform3D>>& points,
+            const std::vector<std::pair<SpotLight, Transform3D>>& spots, JobSystem& jobs)
+        {
+            if(proj != m_Proj || nearPlane != m_Near || farPlane != m_Far)
+            {
+                ComputeBounds(proj, nearPlane, farPlane);
+            }
+
+            m_Lights.clear();
+            m_X.clear(); m_Y.clear(); m_Z.clear(); m_R.clear();
+
+            for(auto& [light, transform] : points)
+            {
+                ClusterLight data;
+                data.Position = glm::vec4(transform.Translate, light.Intensity);
+                data.Radiance = glm::vec4(light.Radiance, Range(light.Radiance, light.Intensity));
+                AddLight(data, view);
+            }
+
+            for(auto& [light, transform] : spots)
+            {
+                // spot radiance is scaled by intensity twice in pbr.glsl
+                auto scale = light.Intensity * light.Intensity;
+                ClusterLight data;
+                data.Position = glm::vec4(transform.Translate, light.Intensity);
+                data.Radiance = glm::vec4(light.Radiance, Range(light.Radiance, scale));
+                data.Direction = glm::vec4(transform.Rotation, 1.0f);
+                data.Cone = glm::vec4(glm::radians(light.FallOff), glm::radians(light.CutOff), 0.0f, 0.0f);
+                AddLight(data, view);
+            }
+
+            // slices are independent, each fills its own index list
+            jobs.ParallelFor(GRID_Z, 1u, [this] (uint32_t begin, uint32_t end)
+            {
+                for(auto z = begin; z < end; z++) { BinSlice(z); }
+            });
+
+            // concatenate slices, cluster offsets become global
+            m_Indices.clear();
+            for(uint32_t z = 0u; z < GRID_Z; z++)
+            {
+                auto offset = static_cast<uint32_t>(m_Indices.size());
+                auto& indices = m_Slices[z].Indices;
+                for(uint32_t c = z * TILES; c < (z + 1u) * TILES; c++) { m_Grid[c].x += offset; }
+                m_Indices.insert(m_Indices.end(), indices.begin(), indices.end());
+            }
+
+            if(m_Indices.size() > static_cast<size_t>(m_MaxTexels))
+            {
+                EMPY_WARN("light clusters exceed texture buffer size, lights dropped!");
+                m_Indices.resize(m_MaxTexels);
+                for(auto& cell : m_Grid)
+                {
+                    cell.x = std::min<uint32_t>(cell.x, m_MaxTexels);
+                    cell.y = std::min<uint32_t>(cell.y, m_MaxTexels - cell.x);
+                }
+            }
+
+            Upload(0u, m_Lights.data(), m_Lights.size() * sizeof(ClusterLight));
+            Upload(1u, m_Grid.data(), m_Grid.size() * sizeof(glm::uvec2));
+            Upload(2u, m_Indices.data(), m_Indices.size() * sizeof(uint32_t));
+        }
+
+        // light data, cluster ranges and indices on three units from unit
+        EMPY_INLINE void Bind(int32_t unit)
+        {
+            for(uint32_t i = 0u; i < 3u; i++)
+            {
+                GLState::Get().ActiveTexture(GL_TEXTURE0 + unit + i);
+                GLState::Get().BindTexture(GL_TEXTURE_BUFFER, m_Textures[i]);
+            }
+        }
+
+        // log(depth) * x + y gives the depth slice
+        EMPY_INLINE glm::vec2 SliceScale() const
+        {
+            auto scale = GRID_Z / std::log(m_Far / m_Near);
+            return glm::vec2(scale, -std::log(m_Near) * scale);
+        }
+
+        EMPY_INLINE glm::vec2 DepthRange() const
+        {
+            return glm::vec2(m_Near, m_Far);
+        }
+
+        EMPY_INLINE uint32_t LightCount() const
+        {
+            return static_cast<uint32_t>(m_Lights.size());
+        }
+
+        EMPY_INLINE uint32_t IndexCount() const
+        {
+            return static_cast<uint32_t>(m_Indices.size());
+        }
+
+    private:
+        // distance at which the light falls under the threshold
+        EMPY_INLINE static float Range(const glm::vec3& radiance, float intensity)
+        {
+            auto peak = std::max(radiance.r, std::max(radiance.g, radiance.b));
+            return std::sqrt(std::max(0.0f, peak * intensity / THRESHOLD));
+        }
+
+        EMPY_INLINE void AddLight(const ClusterLight& light, const glm::mat4& view)
+        {
+            if(light.Radiance.w <= 0.0f) { return; }
+            auto position = view * glm::vec4(glm::vec3(light.Position), 1.0f);
+            m_Lights.push_back(light);
+            m_X.push_back(position.x);
+            m_Y.push_back(position.y);
+            m_Z.push_back(-position.z);
+            m_R.push_back(light.Radiance.w);
+        }
+
+        // exponential slice boundary, view depth
+        EMPY_INLINE float SliceDepth(uint32_t z) const
+        {
+            return m_Near * std::pow(m_Far / m_Near, z / static_cast<float>(GRID_Z));
+        }
+
+        // view space bounds of every cluster, x y view and z depth
+        EMPY_INLINE void ComputeBounds(const glm::mat4& proj, float nearPlane, float farPlane)
+        {
+            m_Proj = proj;
+            m_Near = std::max(nearPlane, 1e-4f);
+            m_Far = std::max(farPlane, m_Near * 2.0f);
+            auto inverse = glm::inverse(proj);
+
+            // ray through a ndc point on the near plane, scaled to unit depth
+            auto ray = [&inverse] (float x, float y)
+            {
+                auto point = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+                point /= point.w;
+                return glm::vec2(point.x, point.y) / std::max(-point.z, 1e-6f);
+            };
+
+            for(uint32_t z = 0u; z < GRID_Z; z++)
+            {
+                float front = SliceDepth(z), back = SliceDepth(z + 1u);
+                for(uint32_t y = 0u; y < GRID_Y; y++)
+                {
+                    for(uint32_t x = 0u; x < GRID_X; x++)
+                    {
+                        auto low = ray(-1.0f + 2.0f * x / GRID_X, -1.0f + 2.0f * y / GRID_Y);
+                        auto high = ray(-1.0f + 2.0f * (x + 1u) / GRID_X, -1.0f + 2.0f * (y + 1u) / GRID_Y);
+                        auto a = glm::min(low * front, low * back), b = glm::max(high * front, high * back);
+
+                        auto cluster = x + GRID_X * (y + GRID_Y * z);
+                        m_Min[cluster] = glm::vec3(glm::min(a, b), front);
+                        m_Max[cluster] = glm::vec3(glm::max(a, b), back);
+                    }
+                }
+            }
+        }
+
+        EMPY_INLINE void BinSlice(uint32_t z)
+        {
+            auto& slice = m_Slices[z];
+            slice.Indices.clear();
+            slice.Lights.clear();
+            slice.X.clear(); slice.Y.clear(); slice.Z.clear(); slice.R2.clear();
+
+            // lights overlapping the slice depth, copied contiguous
+            float front = SliceDepth(z), back = SliceDepth(z + 1u);
+            for(uint32_t i = 0u; i < m_Lights.size(); i++)
+            {
+                if(m_Z[i] + m_R[i] < front || m_Z[i] - m_R[i] > back) { continue; }
+                slice.Lights.push_back(i);
+                slice.X.push_back(m_X[i]);
+                slice.Y.push_back(m_Y[i]);
+                slice.Z.push_back(m_Z[i]);
+                slice.R2.push_back(m_R[i] * m_R[i]);
+            }
+
+            auto count = static_cast<uint32_t>(slice.Lights.size());
+            slice.Hits.resize(count);
+            auto hits = slice.Hits.data();
+            auto px = slice.X.data(), py = slice.Y.data(), pz = slice.Z.data(), r2 = slice.R2.data();
+
+            for(uint32_t c = z * TILES; c < (z + 1u) * TILES; c++)
+            {
+                auto min = m_Min[c], max = m_Max[c];
+
+                // sphere vs box, branch free so it vectorizes
+                for(uint32_t k = 0u; k < count; k++)
+                {
+                    auto dx = std::max(min.x - px[k], 0.0f) + std::max(px[k] - max.x, 0.0f);
+                    auto dy = std::max(min.y - py[k], 0.0f) + std::max(py[k] - max.y, 0.0f);
+                    auto dz = std::max(min.z - pz[k], 0.0f) + std::max(pz[k] - max.z, 0.0f);
+                    hits[k] = (dx * dx + dy * dy + dz * dz) <= r2[k];
+                }
+
+                auto first = static_cast<uint32_t>(slice.Indices.size());
+                for(uint32_t k = 0u; k < count && slice.Indices.size() - first < MAX_PER_CLUSTER; k++)
+                {
+                    if(hits[k]) { slice.Indices.push_back(slice.Lights[k]); }
+                }
+                m_Grid[c] = glm::uvec2(first, static_cast<uint32_t>(slice.Indices.size()) - first);
+            }
+        }
+
+        EMPY_INLINE void Upload(uint32_t buffer, const void* data, size_t bytes)
+        {
+            // texture buffers must not be empty
+            static const glm::vec4 sEmpty(0.0f);
+            if(bytes == 0u) { data = &sEmpty; bytes = sizeof(sEmpty); }
+
+            glBindBuffer(GL_TEXTURE_BUFFER, m_Buffers[buffer]);
+            glBufferData(GL_TEXTURE_BUFFER, bytes, data, GL_STREAM_DRAW);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
+    private:
+        std::vector<ClusterSlice> m_Slices;
+        std::vector<ClusterLight> m_Lights;
+        std::vector<uint32_t> m_Indices;
+        std::vector<glm::uvec2> m_Grid;
+        std::vector<glm::vec3> m_Min;
+        std::vector<glm::vec3> m_Max;
+        std::vector<float> m_X, m_Y, m_Z, m_R;
+
+        uint32_t m_Buffers[3];
+        uint32_t m_Textures[3];
+        int32_t m_MaxTexels = 65536;
+
+        glm::mat4 m_Proj = glm::mat4(0.0f);
+        float m_Near = 0.0f;
+        float m_Far = 0.0f;
+    };
+}
@@ -3,52 +3,6 @@
 
 namespace Empy
 {
-    struct MaterialUniform 
-    {
-        EMPY_INLINE void Initialize(uint32_t shader)
-        {
-            UseRoughnessMap = glGetUniformLocation(shader, "u_material.UseRoughnessMap");
-            UseOcclusionMap = glGetUniformLocation(shader, "u_material.UseOcclusionMap");
-            UseEmissiveMap = glGetUniformLocation(shader, "u_material.UseEmissiveMap");
-            UseMetallicMap = glGetUniformLocation(shader, "u_material.UseMetallicMap");
-            UseAlbedoMap = glGetUniformLocation(shader, "u_material.UseAlbedoMap");
-            UseNormalMap = glGetUniformLocation(shader, "u_material.UseNormalMap");
-
-            RoughnessMap = glGetUniformLocation(shader, "u_material.RoughnessMap");
-            OcclusionMap = glGetUniformLocation(shader, "u_material.OcclusionMap");
-            EmissiveMap = glGetUniformLocation(shader, "u_material.EmissiveMap");
-            MetallicMap = glGetUniformLocation(shader, "u_material.MetallicMap");
-            AlbedoMap = glGetUniformLocation(shader, "u_material.AlbedoMap");
-            NormalMap = glGetUniformLocation(shader, "u_material.NormalMap");
-
-            Roughness = glGetUniformLocation(shader, "u_material.Roughness");
-            Occlusion = glGetUniformLocation(shader, "u_material.Occlusion");
-            Emissive = glGetUniformLocation(shader, "u_material.Emissive");
-            Metallic = glGetUniformLocation(shader, "u_material.Metallic");
-            Albedo = glGetUniformLocation(shader, "u_material.Albedo");
-        }
-
-        uint32_t UseRoughnessMap = 0u;
-        uint32_t UseOcclusionMap = 0u;
-        uint32_t UseEmissiveMap = 0u;
-        uint32_t UseMetallicMap = 0u;
-        uint32_t UseAlbedoMap = 0u;
-        uint32_t UseNormalMap = 0u;
-        // --
-        uint32_t RoughnessMap = 0u; 
-        uint32_t OcclusionMap = 0u;  
-        uint32_t EmissiveMap = 0u;  
-        uint32_t MetallicMap = 0u;  
-        uint32_t AlbedoMap = 0u;    
-        uint32_t NormalMap = 0u;    
-        // --
-        uint32_t Roughness = 0u;
-        uint32_t Occlusion = 0u;
-        uint32_t Emissive = 0u;
-        uint32_t Metallic = 0u;
-        uint32_t Albedo = 0u;
-    };
-
     // pbr material
     struct Material 
     {
@@ -113,13 +67,50 @@ namespace Empy
         EMPY_INLINE glm::mat4 Matrix() const 
         {
             return (glm::translate(glm::mat4(1.0f), Translate) * 
-            glm::toMat4(glm::quat(glm::radians(Rotation))) * 
-            glm::scale(glm::mat4(1.0f), Scale));
+            glm::toMat4(Quaternion()) * glm::scale(glm::mat4(1.0f), Scale));
+        }
+
+        // orientation, euler angles unless a quaternion was set
+        EMPY_INLINE glm::quat Quaternion() const 
+        {
+            return UseOrientation ? Orientation : glm::quat(glm::radians(Rotation));
+        }
+
+        // euler angles in degrees
+        EMPY_INLINE glm::vec3 Euler() const 
+        {
+            return UseOrientation ? glm::degrees(glm::eulerAngles(Orientation)) : Rotation;
+        }
+
+        // quaternion becomes authoritative
+        EMPY_INLINE void SetQuaternion(const glm::quat& orientation) 
+        {
+            Orientation = orientation;
+            UseOrientation = true;
+        }
+
+        // euler angles become authoritative
+        EMPY_INLINE void SetEuler(const glm::vec3& rotation) 
+        {
+            UseOrientation = false;
+            Rotation = rotation;
+        }
+
+        EMPY_INLINE bool operator==(const Transform3D& other) const 
+        {
+            return (Translate == other.Translate && 
+            Rotation == other.Rotation && Scale == other.Scale &&
+            UseOrientation == other.UseOrientation && 
+            (!UseOrientation || Orientation == other.Orientation));
         }
 
         glm::vec3 Translate = glm::vec3(0.0f);  
         glm::vec3 Rotation = glm::vec3(0.0f);    
         glm::vec3 Scale = glm::vec3(1.0f);
+
+        // set by physics, skips euler conversion
+        glm::quat Orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        bool UseOrientation = false;
     };
 
     // camera
@@ -137,7 +128,7 @@ namespace Empy
         {
             return glm::lookAt(transform.Translate, (transform.Translate + 
             glm::vec3(0.0f, 0.0f, -1.0f)), glm::vec3(0.0f, 1.0f, 0.0f)) * 
-            glm::toMat4(glm::quat(glm::radians(transform.Rotation)));
+            glm::toMat4(transform.Quaternion());
         }
 
         EMPY_INLINE glm::mat4 Projection(float ratio) const 
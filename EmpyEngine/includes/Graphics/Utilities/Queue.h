@@ -0,0 +1,136 @@
+#pragma once
+#include "Common/Jobs.h"
+
+namespace Empy
+{
+    // draw packet, key decides the draw order
+    struct RenderPacket
+    {
+        uint64_t Key = 0u;
+        // submitted item
+        uint32_t Item = 0u;
+    };
+
+    // render passes, in draw order
+    enum class RenderPass : uint8_t
+    {
+        DEPTH = 0,
+        COLOR
+    };
+
+    // packets sorted by key, radix sort on the job system
+    struct RenderQueue
+    {
+        // key layout from the top: pass 4, variant 4, material 16, mesh 16, depth 24
+        static constexpr uint32_t DEPTH_BITS = 24u;
+        static constexpr uint32_t MESH_SHIFT = DEPTH_BITS;
+        static constexpr uint32_t MATERIAL_SHIFT = MESH_SHIFT + 16u;
+        static constexpr uint32_t VARIANT_SHIFT = MATERIAL_SHIFT + 16u;
+        static constexpr uint32_t PASS_SHIFT = VARIANT_SHIFT + 4u;
+        // packets per sorting job
+        static constexpr uint32_t CHUNK = 8192u;
+        static constexpr uint32_t RADIX = 256u;
+
+        // depth is in [0, 1], nearest first
+        EMPY_INLINE static uint64_t MakeKey(RenderPass pass, uint32_t variant,
+            uint32_t material, uint32_t mesh, float depth)
+        {
+            auto quantized = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * ((1u << DEPTH_BITS) - 1u));
+            return (static_cast<uint64_t>(pass) << PASS_SHIFT) |
+                (static_cast<uint64_t>(variant & 0xFu) << VARIANT_SHIFT) |
+                (static_cast<uint64_t>(material & 0xFFFFu) << MATERIAL_SHIFT) |
+                (static_cast<uint64_t>(mesh & 0xFFFFu) << MESH_SHIFT) | quantized;
+        }
+
+        // packets of a state group differ in depth only
+        EMPY_INLINE static uint64_t StateBits(uint64_t key)
+        {
+            return key >> DEPTH_BITS;
+        }
+
+        EMPY_INLINE static RenderPass Pass(uint64_t key)
+        {
+            return static_cast<RenderPass>(key >> PASS_SHIFT);
+        }
+
+        EMPY_INLINE void Push(uint64_t key, uint32_t item)
+        {
+            m_Packets.push_back({ key, item });
+        }
+
+        EMPY_INLINE void Clear()
+        {
+            m_Packets.clear();
+        }
+
+        EMPY_INLINE const std::vector<RenderPacket>& Packets() const
+        {
+            return m_Packets;
+        }
+
+        // stable lsd radix sort, 8 bits per pass, bytes equal in every key are skipped
+        EMPY_INLINE void Sort(JobSystem& jobs)
+        {
+            auto count = static_cast<uint32_t>(m_Packets.size());
+            if(count < 2u) { return; }
+
+            auto chunks = (count + CHUNK - 1u) / CHUNK;
+            m_Scratch.resize(count);
+            m_Counts.resize(chunks);
+
+            for(uint32_t shift = 0u; shift < 64u; shift += 8u)
+            {
+                // digit histogram of every chunk
+                jobs.ParallelFor(chunks, 1u, [this, shift, count] (uint32_t begin, uint32_t end)
+                {
+                    for(auto chunk = begin; chunk < end; chunk++)
+                    {
+                        auto& counts = m_Counts[chunk];
+                        counts.fill(0u);
+                        auto last = std::min(count, (chunk + 1u) * CHUNK);
+                        for(auto i = chunk * CHUNK; i < last; i++)
+                        {
+                            counts[(m_Packets[i].Key >> shift) & (RADIX - 1u)]++;
+                        }
+                    }
+                });
+
+                // chunk offsets per digit, digit major keeps the sort stable
+                uint32_t offset = 0u;
+                bool uniform = false;
+                for(uint32_t digit = 0u; digit < RADIX; digit++)
+                {
+                    auto start = offset;
+                    for(auto& counts : m_Counts)
+                    {
+                        auto size = counts[digit];
+                        counts[digit] = offset;
+                        offset += size;
+                    }
+                    if(offset - start == count) { uniform = true; break; }
+                }
+                if(uniform) { continue; }
+
+                jobs.ParallelFor(chunks, 1u, [this, shift, count] (uint32_t begin, uint32_t end)
+                {
+                    for(auto chunk = begin; chunk < end; chunk++)
+                    {
+                        auto& offsets = m_Counts[chunk];
+                        auto last = std::min(count, (chunk + 1u) * CHUNK);
+                        for(auto i = chunk * CHUNK; i < last; i++)
+                        {
+                            auto& packet = m_Packets[i];
+                            m_Scratch[offsets[(packet.Key >> shift) & (RADIX - 1u)]++] = packet;
+                        }
+                    }
+                });
+                std::swap(m_Packets, m_Scratch);
+            }
+        }
+
+    private:
+        std::vector<std::array<uint32_t, RADIX>> m_Counts;
+        std::vector<RenderPacket> m_Scratch;
+        std::vector<RenderPacket> m_Packets;
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include "Common/Core.h"
+
+namespace Empy
+{
+    // state changes of one frame, issued or skipped
+    struct GLStats
+    {
+        uint32_t Programs = 0u;
+        uint32_t Textures = 0u;
+        uint32_t Arrays = 0u;
+        uint32_t Uniforms = 0u;
+    };
+
+    // mirrors bound gl objects, binds that match are skipped
+    struct GLState
+    {
+        static constexpr uint32_t MAX_UNITS = 32u;
+        // cached texture targets per unit
+        static constexpr uint32_t TARGETS = 3u;
+        static constexpr uint32_t UNKNOWN = ~0u;
+
+        EMPY_INLINE static GLState& Get()
+        {
+            static GLState sState;
+            return sState;
+        }
+
+        EMPY_INLINE void UseProgram(uint32_t program)
+        {
+            if(m_Program == program) { m_Skipped.Programs++; return; }
+            glUseProgram(program);
+            m_Program = program;
+            m_Issued.Programs++;
+        }
+
+        // takes GL_TEXTUREi like glActiveTexture
+        EMPY_INLINE void ActiveTexture(uint32_t texture)
+        {
+            auto unit = texture - GL_TEXTURE0;
+            if(m_Unit == unit) { return; }
+            glActiveTexture(texture);
+            m_Unit = unit;
+        }
+
+        // binds to the active unit
+        EMPY_INLINE void BindTexture(uint32_t target, uint32_t texture)
+        {
+            auto slot = Slot(target);
+            if(slot != UNKNOWN && m_Textures[slot] == texture) { m_Skipped.Textures++; return; }
+            glBindTexture(target, texture);
+            if(slot != UNKNOWN) { m_Textures[slot] = texture; }
+            m_Issued.Textures++;
+        }
+
+        EMPY_INLINE void BindVertexArray(uint32_t array)
+        {
+            if(m_Array == array) { m_Skipped.Arrays++; return; }
+            glBindVertexArray(array);
+            m_Array = array;
+            m_Issued.Arrays++;
+        }
+
+        // uniform caches live in the shaders, only counted here
+        EMPY_INLINE void CountUniform(bool skipped)
+        {
+            if(skipped) { m_Skipped.Uniforms++; } else { m_Issued.Uniforms++; }
+        }
+
+        // deleted names may be reused, drop them from the cache
+        EMPY_INLINE void DeleteTextures(int32_t count, const uint32_t* textures)
+        {
+            for(int32_t i = 0; i < count; i++)
+            {
+                std::replace(m_Textures.begin(), m_Textures.end(), textures[i], UNKNOWN);
+            }
+            glDeleteTextures(count, textures);
+        }
+
+        EMPY_INLINE void DeleteVertexArrays(int32_t count, const uint32_t* arrays)
+        {
+            for(int32_t i = 0; i < count; i++)
+            {
+                if(m_Array == arrays[i]) { m_Array = UNKNOWN; }
+            }
+            glDeleteVertexArrays(count, arrays);
+        }
+
+        EMPY_INLINE void DeleteProgram(uint32_t program)
+        {
+            if(m_Program == program) { m_Program = UNKNOWN; }
+            glDeleteProgram(program);
+        }
+
+        // forgets everything, e.g. after foreign code touched the context
+        EMPY_INLINE void Invalidate()
+        {
+            m_Textures.fill(UNKNOWN);
+            m_Program = UNKNOWN;
+            m_Array = UNKNOWN;
+            m_Unit = UNKNOWN;
+        }
+
+        // closes the frame counters
+        EMPY_INLINE void EndFrame()
+        {
+            m_LastIssued = m_Issued;
+            m_LastSkipped = m_Skipped;
+            m_Issued = GLStats();
+            m_Skipped = GLStats();
+        }
+
+        // changes sent to gl in the last frame
+        EMPY_INLINE const GLStats& Issued() const
+        {
+            return m_LastIssued;
+        }
+
+        // changes avoided in the last frame
+        EMPY_INLINE const GLStats& Skipped() const
+        {
+            return m_LastSkipped;
+        }
+
+    private:
+        EMPY_INLINE GLState()
+        {
+            Invalidate();
+        }
+
+        // cache slot of target on the active unit
+        EMPY_INLINE uint32_t Slot(uint32_t target) const
+        {
+            if(m_Unit >= MAX_UNITS) { return UNKNOWN; }
+            switch(target)
+            {
+                case GL_TEXTURE_2D: return m_Unit * TARGETS;
+                case GL_TEXTURE_CUBE_MAP: return m_Unit * TARGETS + 1u;
+                case GL_TEXTURE_BUFFER: return m_Unit * TARGETS + 2u;
+                default: return UNKNOWN;
+            }
+        }
+
+    private:
+        std::array<uint32_t, MAX_UNITS * TARGETS> m_Textures;
+        uint32_t m_Program = UNKNOWN;
+        uint32_t m_Array = UNKNOWN;
+        uint32_t m_Unit = UNKNOWN;
+
+        GLStats m_LastSkipped;
+        GLStats m_LastIssued;
+        GLStats m_Skipped;
+        GLStats m_Issued;
+    };
+}
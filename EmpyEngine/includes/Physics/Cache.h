@@ -0,0 +1,203 @@
+#pragma once
+#include "Utilities.h"
+#include <map>
+
+namespace Empy
+{
+    // shares materials and shapes between identical colliders
+    struct PxColliderCache
+    {
+        EMPY_INLINE PxColliderCache() = default;
+
+        EMPY_INLINE void Init(PxPhysics* physics)
+        {
+            m_Physics = physics;
+        }
+
+        // returns shared material, one reference per call
+        EMPY_INLINE PxMaterial* AcquireMaterial(const Collider3D& collider)
+        {
+            MaterialKey key(collider.StaticFriction, collider.DynamicFriction, collider.Restitution);
+            if(auto itr = m_MaterialKeys.find(key); itr != m_MaterialKeys.end())
+            {
+                m_Materials[itr->second].Refs++;
+                return itr->second;
+            }
+
+            auto material = m_Physics->createMaterial(collider.StaticFriction, 
+                collider.DynamicFriction, collider.Restitution);
+            if(!material) { return nullptr; }
+
+            m_Materials[material] = { key, 1u };
+            m_MaterialKeys[key] = material;
+            return material;
+        }
+
+        // returns shared shape, size is the transform scale
+        EMPY_INLINE PxShape* AcquireShape(ColliderType type, const glm::vec3& size, 
+            PxMaterial* material, PxBase* mesh, const PxFilterData& filter)
+        {
+            ShapeKey key(type, size.x, size.y, size.z, material, mesh, 
+                filter.word0, filter.word1, filter.word2, filter.word3);
+            if(auto itr = m_ShapeKeys.find(key); itr != m_ShapeKeys.end())
+            {
+                m_Shapes[itr->second].Refs++;
+                return itr->second;
+            }
+
+            // non exclusive shapes can be attached to many actors
+            PxShape* shape = nullptr;
+            if(type == ColliderType::BOX)
+            {
+                PxBoxGeometry box(ToPxVec3(size/2.0f));
+                shape = m_Physics->createShape(box, *material, false);
+            }
+            else if(type == ColliderType::SPHERE)
+            {
+                PxSphereGeometry sphere(size.x/2.0f);
+                shape = m_Physics->createShape(sphere, *material, false);
+            }
+            else if(type == ColliderType::CONVEX && mesh)
+            {
+                PxConvexMeshGeometry convex(static_cast<PxConvexMesh*>(mesh), PxMeshScale(ToPxVec3(size)));
+                shape = m_Physics->createShape(convex, *material, false);
+            }
+            else if(type == ColliderType::MESH && mesh)
+            {
+                PxTriangleMeshGeometry triangles(static_cast<PxTriangleMesh*>(mesh), PxMeshScale(ToPxVec3(size)));
+                shape = m_Physics->createShape(triangles, *material, false);
+            }
+            if(!shape) { return nullptr; }
+
+            SetFilter(shape, filter);
+            m_Shapes[shape] = { key, 1u };
+            m_ShapeKeys[key] = shape;
+            return shape;
+        }
+
+        // same shape with other filter data, one reference per call
+        EMPY_INLINE PxShape* AcquireFiltered(PxShape* shape, const PxFilterData& filter)
+        {
+            auto itr = m_Shapes.find(shape);
+            if(itr == m_Shapes.end()) { return nullptr; }
+
+            auto key = itr->second.Key;
+            std::get<6>(key) = filter.word0;
+            std::get<7>(key) = filter.word1;
+            std::get<8>(key) = filter.word2;
+            std::get<9>(key) = filter.word3;
+
+            if(auto found = m_ShapeKeys.find(key); found != m_ShapeKeys.end())
+            {
+                m_Shapes[found->second].Refs++;
+                return found->second;
+            }
+
+            // copy geometry and material of the source shape
+            auto material = std::get<4>(key);
+            auto copy = m_Physics->createShape(shape->getGeometry().any(), *material, false);
+            if(!copy) { return nullptr; }
+
+            SetFilter(copy, filter);
+            m_Shapes[copy] = { key, 1u };
+            m_ShapeKeys[key] = copy;
+            return copy;
+        }
+
+        // takes a reference to a material created elsewhere, e.g. a snapshot
+        EMPY_INLINE void Adopt(PxMaterial* material, const Collider3D& collider)
+        {
+            MaterialKey key(collider.StaticFriction, collider.DynamicFriction, collider.Restitution);
+            auto& entry = m_Materials[material];
+            if(entry.Refs++ == 0u) { entry.Key = key; }
+            m_MaterialKeys.emplace(key, material);
+        }
+
+        // same for shapes, later identical colliders share it
+        EMPY_INLINE void Adopt(PxShape* shape, ColliderType type, const glm::vec3& size, PxMaterial* material)
+        {
+            PxBase* mesh = nullptr;
+            auto geometry = shape->getGeometry();
+            if(type == ColliderType::CONVEX) { mesh = geometry.convexMesh().convexMesh; }
+            if(type == ColliderType::MESH) { mesh = geometry.triangleMesh().triangleMesh; }
+
+            auto filter = shape->getSimulationFilterData();
+            ShapeKey key(type, size.x, size.y, size.z, material, mesh, 
+                filter.word0, filter.word1, filter.word2, filter.word3);
+            auto& entry = m_Shapes[shape];
+            if(entry.Refs++ == 0u) { entry.Key = key; }
+            m_ShapeKeys.emplace(key, shape);
+        }
+
+        // true if the cache holds a reference
+        EMPY_INLINE bool Owns(PxMaterial* material) const
+        {
+            return m_Materials.count(material) > 0u;
+        }
+
+        EMPY_INLINE bool Owns(PxShape* shape) const
+        {
+            return m_Shapes.count(shape) > 0u;
+        }
+
+        // drops one reference, frees material when unused
+        EMPY_INLINE void Release(PxMaterial* material)
+        {
+            auto itr = m_Materials.find(material);
+            if(itr == m_Materials.end() || --itr->second.Refs > 0u) { return; }
+            auto key = m_MaterialKeys.find(itr->second.Key);
+            if(key != m_MaterialKeys.end() && key->second == material) { m_MaterialKeys.erase(key); }
+            m_Materials.erase(itr);
+            material->release();
+        }
+
+        // drops one reference, frees shape when unused
+        EMPY_INLINE void Release(PxShape* shape)
+        {
+            auto itr = m_Shapes.find(shape);
+            if(itr == m_Shapes.end() || --itr->second.Refs > 0u) { return; }
+            auto key = m_ShapeKeys.find(itr->second.Key);
+            if(key != m_ShapeKeys.end() && key->second == shape) { m_ShapeKeys.erase(key); }
+            m_Shapes.erase(itr);
+            shape->release();
+        }
+
+        // frees everything, call before physics is released
+        EMPY_INLINE void Clear()
+        {
+            for(auto& [shape, entry] : m_Shapes) { shape->release(); }
+            for(auto& [material, entry] : m_Materials) { material->release(); }
+            m_MaterialKeys.clear();
+            m_Materials.clear();
+            m_ShapeKeys.clear();
+            m_Shapes.clear();
+        }
+
+    private:
+        // scene queries test their mask against the layer bit
+        EMPY_INLINE static void SetFilter(PxShape* shape, const PxFilterData& filter)
+        {
+            shape->setQueryFilterData(PxFilterData(filter.word0, 0u, 0u, 0u));
+            shape->setSimulationFilterData(filter);
+        }
+
+    private:
+        using MaterialKey = std::tuple<float, float, float>;
+        using ShapeKey = std::tuple<ColliderType, float, float, float, PxMaterial*, 
+            PxBase*, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+        template <typename T>
+        struct Entry
+        {
+            T Key;
+            uint32_t Refs = 0u;
+        };
+
+    private:
+        std::unordered_map<PxMaterial*, Entry<MaterialKey>> m_Materials;
+        std::unordered_map<PxShape*, Entry<ShapeKey>> m_Shapes;
+        std::map<MaterialKey, PxMaterial*> m_MaterialKeys;
+        std::map<ShapeKey, PxShape*> m_ShapeKeys;
+        PxPhysics* m_Physics = nullptr;
+    };
+}
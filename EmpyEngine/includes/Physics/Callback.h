@@ -1,5 +1,6 @@
 #pragma once
 #include "Auxiliaries/ECS.h"
+#include "Helpers.h"
 
 namespace Empy
 {
@@ -17,55 +18,80 @@ namespace Empy
         EntityID Entity1 = NENTT;
         EntityID Entity2 = NENTT;
         PxEvent Event = PxEvent::UNKNOWN;
+        // first contact of the pair (world space)
+        glm::vec3 Point = glm::vec3(0.0f);
+        glm::vec3 Normal = glm::vec3(0.0f);
+        // summed impulse magnitude over the frame
+        float Impulse = 0.0f;
     };
 
-    using PxCallbackFunction = std::function<void(const PxPayload&)>;
-
     struct PxEventCallback : public PxSimulationEventCallback 
     {
+        EMPY_INLINE PxEventCallback()
+        {
+            m_Events.reserve(1024u);
+            m_Pairs.reserve(1024u);
+        }
+
         // override the onContact callback
         EMPY_INLINE void onContact(const PxContactPairHeader& header, const 
         PxContactPair* pairs, PxU32 nbPairs) override  
         {
-            // collision actors
-            auto actor1 = header.actors[0];
-            auto actor2 = header.actors[1];
+            // released actors have dangling user data
+            if (header.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | 
+                PxContactPairHeaderFlag::eREMOVED_ACTOR_1)) 
+            { return; }
 
-            // check if actors
-            if (m_Callback && actor1 && actor2) 
+            PxContactPairPoint points[MAX_POINTS];
+            for (PxU32 i = 0; i < nbPairs; ++i) 
             {
-                PxPayload event;
-                event.Event = PxEvent::CONTACT;
-                event.Entity1 = *static_cast<EntityID*>(actor1->userData);
-                event.Entity2 = *static_cast<EntityID*>(actor2->userData);
-                m_Callback(event);                     
-            }
+                if (!(pairs[i].events & PxPairFlag::eNOTIFY_TOUCH_FOUND)) { continue; }
+
+                auto payload = Append(header.actors[0], header.actors[1], PxEvent::CONTACT);
+                if (!payload) { return; }
 
-            EMPY_DEBUG("onContact Event!");
+                PxU32 count = pairs[i].extractContacts(points, MAX_POINTS);
+                for (PxU32 k = 0; k < count; ++k) 
+                {
+                    payload->Impulse += points[k].impulse.magnitude();
+                }
+
+                if (count > 0u && payload->Normal == glm::vec3(0.0f)) 
+                {
+                    payload->Point = PxToVec3(points[0].position);
+                    payload->Normal = PxToVec3(points[0].normal);
+                }
+            }
         }
    
         // override the onTrigger callback
         EMPY_INLINE void onTrigger(PxTriggerPair* pairs, PxU32 nbPairs) override  
         {
-             for (PxU32 i = 0; m_Callback && i < nbPairs; ++i) 
-             {
-                // Access actor pointers from the trigger pair
-                const PxRigidActor* actor0 = pairs[i].triggerActor;
-                const PxRigidActor* actor1 = pairs[i].otherActor;
-
-                // Check if actors are valid before using
-                if (actor0 && actor1) 
-                {
-                    PxPayload event;
-                    event.Event = PxEvent::TRIGGER;
-                    event.Entity1 = *static_cast<EntityID*>(actor1->userData);
-                    event.Entity2 = *static_cast<EntityID*>(actor0->userData);
-                    m_Callback(event);                     
-                }
+            for (PxU32 i = 0; i < nbPairs; ++i) 
+            {
+                // skip pairs with released shapes
+                if (pairs[i].flags & (PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER | 
+                    PxTriggerPairFlag::eREMOVED_SHAPE_OTHER)) 
+                { continue; }
+
+                Append(pairs[i].otherActor, pairs[i].triggerActor, PxEvent::TRIGGER);
             }
-            EMPY_DEBUG("onTrigger Event!");
         }
-        
+
+        // delivers buffered events once, task(const PxPayload&), returns count
+        template <typename Task>
+        EMPY_INLINE uint32_t Dispatch(Task&& task)
+        {
+            for (auto& payload : m_Events) 
+            { 
+                task(payload); 
+            }
+            auto count = static_cast<uint32_t>(m_Events.size());
+            m_Events.clear();
+            m_Pairs.clear();
+            return count;
+        }
+
 	    EMPY_INLINE void onAdvance(const PxRigidBody*const* bodyBuffer, 
         const PxTransform* poseBuffer, const PxU32 count) override {}
 
@@ -79,7 +105,32 @@ namespace Empy
         constraints, PxU32 count) override {}
 
     private:
-        PxCallbackFunction m_Callback;
-        friend struct PhysicsContext;
+        // one payload per entity pair, filter shader dropped unwanted pairs
+        EMPY_INLINE PxPayload* Append(const PxActor* actor1, const PxActor* actor2, PxEvent event)
+        {
+            if (!actor1 || !actor2 || !actor1->userData || !actor2->userData) { return nullptr; }
+
+            auto entity1 = PxToEntity(actor1->userData);
+            auto entity2 = PxToEntity(actor2->userData);
+
+            // order independent pair key
+            auto id1 = static_cast<uint64_t>(entt::to_integral(entity1));
+            auto id2 = static_cast<uint64_t>(entt::to_integral(entity2));
+            uint64_t key = (std::min(id1, id2) << 32u) | std::max(id1, id2);
+
+            auto [itr, inserted] = m_Pairs.try_emplace(key, static_cast<uint32_t>(m_Events.size()));
+            if (!inserted) { return &m_Events[itr->second]; }
+
+            auto& payload = m_Events.emplace_back();
+            payload.Entity1 = entity1;
+            payload.Entity2 = entity2;
+            payload.Event = event;
+            return &payload;
+        }
+
+    private:
+        static constexpr PxU32 MAX_POINTS = 16u;
+        std::unordered_map<uint64_t, uint32_t> m_Pairs;
+        std::vector<PxPayload> m_Events;
     };
 } 
@@ -1,12 +1,20 @@
 #pragma once
 #include "Callback.h"
 #include "Utilities.h"
+#include "Dispatcher.h"
+#include "Cache.h"
+#include "Cooking.h"
+#include "Queries.h"
+#include "Snapshot.h"
+#include <unordered_set>
+#include <set>
 
 namespace Empy
 {
     struct PhysicsContext
     {
-        EMPY_INLINE PhysicsContext() 
+        EMPY_INLINE PhysicsContext(EntityRegistry* registry, AssetRegistry* assets, JobSystem* jobs):
+            m_Dispatcher(jobs), m_Registry(registry), m_Assets(assets), m_Jobs(jobs)
         {
             // sinitialize physX SDK
             m_Foundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_AllocatorCallback, m_ErrorCallback);
@@ -25,18 +33,8 @@ namespace Empy
                 return;
             }
 
-            // create worker threads
-            m_Dispatcher = PxDefaultCpuDispatcherCreate(2); 
-
-            // create a scene desciption
-            PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
-            sceneDesc.simulationEventCallback = &m_EventCallback;
-            sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
-            sceneDesc.filterShader = CustomFilterShader;
-            sceneDesc.cpuDispatcher = m_Dispatcher;
-
             // create scene instance
-            m_Scene = m_Physics->createScene(sceneDesc);            
+            m_Scene = CreateScene();            
             if (!m_Scene) 
             {
                 EMPY_ERROR("Error creating PhysX m_Scene");
@@ -44,26 +42,540 @@ namespace Empy
                 m_Foundation->release();
                 return;
             }   
+
+            // destroyed bodies give back their actor and collider
+            m_Registry->on_destroy<RigidBodyComponent>().connect<&PhysicsContext::OnDestroyBody>(*this);
+            // entity destroy removes colliders before bodies
+            m_Registry->on_destroy<ColliderComponent>().connect<&PhysicsContext::OnDestroyCollider>(*this);
+            // scripted entities may listen for contacts, narrowed once the script runs
+            m_Registry->on_construct<ScriptComponent>().connect<&PhysicsContext::OnScriptAdded>(*this);
+            m_Registry->on_destroy<ScriptComponent>().connect<&PhysicsContext::OnScriptRemoved>(*this);
+            m_Cooker.Init(m_Foundation, m_Physics, "Resources/Cache/Physics");
+            m_Snapshot.Init(m_Physics);
+            m_Cache.Init(m_Physics);
+
+            // without regions the main scene covers everything
+            m_Regions.push_back({ m_Scene, PxBounds3(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32)) });
+            m_Queries.Init(m_Jobs);
+            m_Queries.AddScene(m_Scene, m_Regions[0].Bounds);
         }
 
         EMPY_INLINE ~PhysicsContext()
         {
-            if (m_Scene) { m_Scene->release(); }
+            // registry may be gone, finish the step without collecting
+            if(m_Simulating)
+            {
+                for(auto& region : m_Regions) { WaitResults(region.Scene); }
+                m_Simulating = false;
+            }
+            m_Queries.Clear();
+            for(auto& region : m_Regions) { region.Scene->release(); }
+            m_Cache.Clear();
+            m_Cooker.Clear();
             if (m_Physics) { m_Physics->release(); }
-            if (m_Dispatcher) { m_Dispatcher->release(); }
             if (m_Foundation) { m_Foundation->release(); }
+            m_Snapshot.Clear();
         }
              
         EMPY_INLINE void AddRigidBody(Entity& entity)
         {                   
-            auto& transform = entity.template Get<TransformComponent>().Transform;
+            // add actor to the scene of its region
+            auto region = CreateActor(entity);
+            if(region >= 0)
+            {
+                auto& body = entity.template Get<RigidBodyComponent>().RigidBody;
+                m_Regions[region].Scene->addActor(*body.Actor);               
+            }
+        }
+
+        // creates actors of all rigid bodies, inserted in one call
+        EMPY_INLINE void AddRigidBodies()
+        {
+            std::vector<std::vector<PxActor*>> actors;
+            auto view = m_Registry->view<RigidBodyComponent, TransformComponent>();
+
+            for(auto entt : view)
+            {
+                Entity entity(m_Registry, entt);
+                auto& body = entity.template Get<RigidBodyComponent>().RigidBody;
+                if(body.Actor) { continue; }
+
+                auto region = CreateActor(entity);
+                if(region < 0) { continue; }
+
+                if(actors.size() <= static_cast<size_t>(region)) { actors.resize(region + 1); }
+                actors[region].push_back(body.Actor); 
+            }
+
+            // one insert per region scene
+            for(size_t i = 0u; i < actors.size(); i++)
+            {
+                if(actors[i].empty()) { continue; }
+                m_Regions[i].Scene->addActors(actors[i].data(), static_cast<PxU32>(actors[i].size()));
+            }
+        }
+
+        // hash of everything snapshot actors are built from: source files,
+        // collider geometry, cooking params and layer matrix
+        EMPY_INLINE uint64_t SnapshotKey(const std::vector<std::string>& sources) const
+        {
+            uint64_t key = m_Cooker.Fingerprint();
+            for(auto& source : sources)
+            {
+                std::ifstream file(source, std::ios::binary);
+                std::string content((std::istreambuf_iterator<char>(file)), {});
+                key = HashBytes(content.data(), content.size(), key);
+            }
+
+            // each model once, in id order
+            std::set<uint64_t> models;
+            for(auto [entity, comp] : m_Registry->view<ColliderComponent>().each())
+            {
+                auto type = comp.Collider.Type;
+                if(type == ColliderType::MESH || type == ColliderType::CONVEX) { models.insert(comp.Collider.Model); }
+            }
+
+            for(auto uid : models)
+            {
+                auto& model = m_Assets->Get<ModelAsset>(uid);
+                if(!model.Data) { continue; }
+                auto& data = model.Data->Collision();
+                key = HashBytes(data.Vertices.data(), data.Vertices.size() * sizeof(glm::vec3), key);
+                key = HashBytes(data.Indices.data(), data.Indices.size() * sizeof(uint32_t), key);
+            }
+            return HashBytes(&m_Layers, sizeof(PxLayerMatrix), key);
+        }
+
+        // writes actors of entities with info, keyed by uid, physics must be idle
+        EMPY_INLINE bool SaveSnapshot(const std::string& path, uint64_t key)
+        {
+            std::vector<std::pair<PxBase*, PxSerialObjectId>> objects;
+            auto view = m_Registry->view<InfoComponent, RigidBodyComponent>();
+            for(auto [entity, info, comp] : view.each())
+            {
+                if(comp.RigidBody.Actor) { objects.emplace_back(comp.RigidBody.Actor, info.UID); }
+            }
+            return m_Snapshot.Save(objects, path, key);
+        }
+
+        // adopts snapshot actors by entity uid if saved with the same key,
+        // bodies left without actor are built by AddRigidBodies()
+        EMPY_INLINE bool LoadSnapshot(const std::string& path, uint64_t key)
+        {
+            auto collection = m_Snapshot.Load(path, key);
+            if(!collection) { return false; }
+
+            // serialized user data belongs to the old registry
+            for(PxU32 i = 0u; i < collection->getNbObjects(); i++)
+            {
+                if(auto actor = collection->getObject(i).is<PxRigidActor>()) { actor->userData = nullptr; }
+            }
+
+            std::vector<std::vector<PxActor*>> actors;
+            auto view = m_Registry->view<InfoComponent, RigidBodyComponent, TransformComponent>();
+            for(auto entt : view)
+            {
+                auto object = collection->find(view.get<InfoComponent>(entt).UID);
+                auto actor = object ? object->is<PxRigidActor>() : nullptr;
+                if(!actor || view.get<RigidBodyComponent>(entt).RigidBody.Actor) { continue; }
+
+                Entity entity(m_Registry, entt);
+                auto region = AdoptActor(entity, actor);
+                if(actors.size() <= region) { actors.resize(region + 1); }
+                actors[region].push_back(actor);
+            }
+
+            // actors of entities no longer in the scene
+            for(PxU32 i = 0u; i < collection->getNbObjects(); i++)
+            {
+                auto actor = collection->getObject(i).is<PxRigidActor>();
+                if(actor && !actor->userData) { actor->release(); }
+            }
+
+            // creation refs the cache didn't adopt, actors and shapes hold their own
+            for(PxU32 i = 0u; i < collection->getNbObjects(); i++)
+            {
+                auto& object = collection->getObject(i);
+                if(auto shape = object.is<PxShape>()) { if(!m_Cache.Owns(shape)) { shape->release(); } }
+                else if(auto material = object.is<PxMaterial>()) { if(!m_Cache.Owns(material)) { material->release(); } }
+                else if(auto mesh = object.is<PxConvexMesh>()) { mesh->release(); }
+                else if(auto mesh = object.is<PxTriangleMesh>()) { mesh->release(); }
+            }
+            collection->release();
+
+            for(size_t i = 0u; i < actors.size(); i++)
+            {
+                if(actors[i].empty()) { continue; }
+                m_Regions[i].Scene->addActors(actors[i].data(), static_cast<PxU32>(actors[i].size()));
+            }
+
+            // subscriptions made before loading
+            for(auto entity : m_Subscribers) { RefreshFilter(entity); }
+            return true;
+        }
+
+        // splits the xz plane in square regions each with its own scene, 
+        // bodies migrate once past border plus margin, call before adding bodies
+        EMPY_INLINE void SetRegions(float size, float margin)
+        {
+            if(m_Regions.size() > 1u || m_Scene->getNbActors(PxActorTypeFlag::eRIGID_STATIC | 
+                PxActorTypeFlag::eRIGID_DYNAMIC))
+            {
+                EMPY_WARN("physics regions must be set before adding bodies!");
+                return;
+            }
+
+            m_RegionMargin = std::max(0.0f, margin);
+            m_RegionSize = std::max(0.0f, size);
+            m_RegionMap.clear();
+
+            // main scene becomes the region at origin
+            m_Regions[0].Bounds = PxBounds3(PxVec3(-PX_MAX_F32), PxVec3(PX_MAX_F32));
+            if(m_RegionSize > 0.0f)
+            {
+                m_Regions[0].Bounds = CellBounds(0, 0);
+                m_RegionMap[CellKey(0, 0)] = 0u;
+            }
+
+            m_Queries.Clear();
+            m_Queries.AddScene(m_Scene, Inflate(m_Regions[0].Bounds));
+        }
+
+        EMPY_INLINE bool HasRegions() const
+        {
+            return m_RegionSize > 0.0f;
+        }
+
+        // number of region scenes created so far
+        EMPY_INLINE uint32_t Regions() const
+        {
+            return static_cast<uint32_t>(m_Regions.size());
+        }
+
+        // adds frame time, returns number of steps due
+        EMPY_INLINE uint32_t Accumulate(double dt)
+        {
+            if(!m_FixedStep)
+            {
+                m_StepTime = static_cast<float>(dt);
+                m_Alpha = 1.0f;
+                return (m_Steps = 1u);
+            }
+
+            // drop time that exceeds the substep budget
+            m_Accumulator += dt;
+            m_Accumulator = std::min(m_Accumulator, (double)m_TimeStep * m_MaxSubSteps);
+            m_Steps = static_cast<uint32_t>(m_Accumulator / m_TimeStep);
+            m_Accumulator -= (double)m_Steps * m_TimeStep;
+
+            m_Alpha = static_cast<float>(m_Accumulator / m_TimeStep);
+            m_StepTime = m_TimeStep;
+            return m_Steps;
+        }
+
+        // fixed step size and max steps per frame
+        EMPY_INLINE void SetTimeStep(float step, uint32_t maxSubSteps)
+        {
+            m_MaxSubSteps = std::max(1u, maxSubSteps);
+            m_TimeStep = step;
+        }
+
+        // variable mode steps once with frame delta
+        EMPY_INLINE void SetFixedStep(bool fixed)
+        {
+            m_Accumulator = 0.0;
+            m_FixedStep = fixed;
+        }
+
+        EMPY_INLINE bool IsFixedStep() const
+        {
+            return m_FixedStep;
+        }
+
+        // step size of the current frame
+        EMPY_INLINE float StepTime() const
+        {
+            return m_StepTime;
+        }
+
+        // steps taken by last Accumulate()
+        EMPY_INLINE uint32_t Steps() const
+        {
+            return m_Steps;
+        }
+
+        // blend factor between previous and current pose
+        EMPY_INLINE float Alpha() const
+        {
+            return m_Alpha;
+        }
+        
+        EMPY_INLINE void Simulate(uint32_t step, float dt)
+        {
+            EMPY_PROFILE_SCOPE("Physics::Simulate");
+            // complete running async step first
+            FetchResults();
+            m_Pending = false;
+
+            for (int i = 0; i < step; ++i) 
+            {
+                // regions simulate side by side on the workers
+                for(auto& region : m_Regions) { region.Scene->simulate(dt); }
+                // block until simulation is complete
+                for(auto& region : m_Regions)
+                {
+                    WaitResults(region.Scene); 
+                    CollectActiveActors(region.Scene);
+                }
+            }
+            MigrateBodies();
+        }
+
+        // starts a step without waiting, see FetchResults()
+        EMPY_INLINE void BeginSimulate(float dt)
+        {
+            EMPY_PROFILE_SCOPE("Physics::BeginSimulate");
+            FetchResults();
+            for(auto& region : m_Regions) { region.Scene->simulate(dt); }
+            m_Simulating = true;
+        }
+
+        // blocks until running step is done, false if none
+        EMPY_INLINE bool FetchResults()
+        {
+            if(!m_Simulating) { return false; }
+            EMPY_PROFILE_SCOPE("Physics::Fetch");
+            for(auto& region : m_Regions)
+            {
+                WaitResults(region.Scene); 
+                CollectActiveActors(region.Scene);
+            }
+            m_Simulating = false;
+            m_Pending = true;
+            MigrateBodies();
+            return true;
+        }
+
+        // fetches, true once per completed async step
+        EMPY_INLINE bool TakeResults()
+        {
+            FetchResults();
+            auto pending = m_Pending;
+            m_Pending = false;
+            return pending;
+        }
+
+        EMPY_INLINE bool IsSimulating() const
+        {
+            return m_Simulating;
+        }
+
+        // last step overlaps the rest of the frame
+        EMPY_INLINE void SetAsync(bool async)
+        {
+            m_Async = async;
+        }
+
+        EMPY_INLINE bool IsAsync() const
+        {
+            return m_Async;
+        }
+
+        // raycasts, sweeps and overlaps run after simulation
+        EMPY_INLINE PxQueryService& Queries()
+        {
+            return m_Queries;
+        }
+
+        // per-task timings of the physx workers
+        EMPY_INLINE PxJobDispatcher& Dispatcher()
+        {
+            return m_Dispatcher;
+        }
+
+        // entities moved since last ClearActiveEntities()
+        EMPY_INLINE const std::vector<EntityID>& ActiveEntities() const
+        {
+            return m_ActiveEntities;
+        }
+
+        EMPY_INLINE void ClearActiveEntities()
+        {
+            m_ActiveEntities.clear();
+        }
+
+        // delivers contacts buffered since last call, task(const PxPayload&)
+        template <typename Task>
+        EMPY_INLINE uint32_t DispatchEvents(Task&& task)
+        {
+            return m_EventCallback.Dispatch(std::forward<Task>(task));
+        }
+
+        // reports contacts and triggers involving entity
+        EMPY_INLINE void Subscribe(EntityID entity, bool subscribe = true)
+        {
+            if(subscribe) { m_Subscribers.insert(entity); }
+            else { m_Subscribers.erase(entity); }
+
+            // existing bodies swap to a shape with the new report flag
+            RefreshFilter(entity);
+        }
+
+        // layers a and b generate contacts, physics must be idle
+        EMPY_INLINE bool SetLayerCollision(uint32_t a, uint32_t b, bool collide)
+        {
+            if(a >= PxLayerMatrix::MAX_LAYERS || b >= PxLayerMatrix::MAX_LAYERS)
+            {
+                EMPY_ERROR("invalid collision layer pair ({}, {})!", a, b);
+                return false;
+            }
+            m_Layers.Set(a, b, collide);
+            UpdateLayers();
+            return true;
+        }
+
+        // pairs touching layer report contacts without subscribers
+        EMPY_INLINE bool SetLayerReport(uint32_t layer, bool report)
+        {
+            if(layer >= PxLayerMatrix::MAX_LAYERS)
+            {
+                EMPY_ERROR("invalid collision layer {}!", layer);
+                return false;
+            }
+            if(report) { m_Layers.Report |= (1u << layer); }
+            else { m_Layers.Report &= ~(1u << layer); }
+            UpdateLayers();
+            return true;
+        }
+
+    private:
+        struct PxRegion
+        {
+            PxScene* Scene;
+            PxBounds3 Bounds;
+        };
+
+        EMPY_INLINE PxScene* CreateScene()
+        {
+            // create a scene desciption
+            PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
+            sceneDesc.simulationEventCallback = &m_EventCallback;
+            sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
+            sceneDesc.filterShader = CustomFilterShader;
+            sceneDesc.filterShaderData = &m_Layers;
+            sceneDesc.filterShaderDataSize = sizeof(PxLayerMatrix);
+            // physx tasks run on the engine workers
+            sceneDesc.cpuDispatcher = &m_Dispatcher;
+
+            // report actors moved by each simulate
+            sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+            return m_Physics->createScene(sceneDesc);
+        }
+
+        // index of region containing point, created on demand
+        EMPY_INLINE uint32_t RegionAt(const PxVec3& point)
+        {
+            if(m_RegionSize <= 0.0f) { return 0u; }
+            auto x = static_cast<int32_t>(std::floor(point.x / m_RegionSize));
+            auto z = static_cast<int32_t>(std::floor(point.z / m_RegionSize));
+
+            auto itr = m_RegionMap.find(CellKey(x, z));
+            if(itr != m_RegionMap.end()) { return itr->second; }
+
+            auto scene = CreateScene();
+            if(!scene)
+            {
+                EMPY_ERROR("Error creating PhysX region scene");
+                return 0u;
+            }
+
+            auto index = static_cast<uint32_t>(m_Regions.size());
+            scene->userData = reinterpret_cast<void*>(static_cast<uintptr_t>(index));
+            m_Regions.push_back({ scene, CellBounds(x, z) });
+            m_RegionMap[CellKey(x, z)] = index;
+            m_Queries.AddScene(scene, Inflate(m_Regions[index].Bounds));
+
+            // statics reaching into the new region get a copy there
+            for(auto [entity, comp] : m_Registry->view<RigidBodyComponent>().each())
+            {
+                auto actor = comp.RigidBody.Actor;
+                if(actor && actor->is<PxRigidStatic>()) { Replicate(actor, index); }
+            }
+            return index;
+        }
+
+        EMPY_INLINE static uint64_t CellKey(int32_t x, int32_t z)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+        }
+
+        // unbounded vertically
+        EMPY_INLINE PxBounds3 CellBounds(int32_t x, int32_t z) const
+        {
+            PxVec3 min(x * m_RegionSize, -PX_MAX_F32, z * m_RegionSize);
+            PxVec3 max((x + 1) * m_RegionSize, PX_MAX_F32, (z + 1) * m_RegionSize);
+            return PxBounds3(min, max);
+        }
+
+        EMPY_INLINE PxBounds3 Inflate(const PxBounds3& bounds) const
+        {
+            PxVec3 margin(m_RegionMargin, 0.0f, m_RegionMargin);
+            return PxBounds3(bounds.minimum - margin, bounds.maximum + margin);
+        }
+
+        // copies static actor into region if their bounds meet
+        EMPY_INLINE void Replicate(PxRigidActor* actor, uint32_t region)
+        {
+            auto home = actor->getScene();
+            if(home && home == m_Regions[region].Scene) { return; }
+            if(!Inflate(m_Regions[region].Bounds).intersects(actor->getWorldBounds())) { return; }
+
+            auto clone = PxCloneStatic(*m_Physics, actor->getGlobalPose(), *actor);
+            if(!clone) { return; }
+
+            clone->userData = actor->userData;
+            m_Regions[region].Scene->addActor(*clone);
+            m_Clones[actor].push_back(clone);
+        }
+
+        // moves bodies that left their region and its margin
+        EMPY_INLINE void MigrateBodies()
+        {
+            if(m_RegionSize <= 0.0f) { return; }
+
+            for(auto entity : m_ActiveEntities)
+            {
+                auto comp = m_Registry->try_get<RigidBodyComponent>(entity);
+                if(!comp || !comp->RigidBody.Actor) { continue; }
+
+                auto actor = comp->RigidBody.Actor;
+                auto scene = actor->getScene();
+                if(!scene) { continue; }
+
+                auto point = actor->getGlobalPose().p;
+                auto current = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(scene->userData));
+                if(Inflate(m_Regions[current].Bounds).contains(point)) { continue; }
+
+                auto target = RegionAt(point);
+                if(target == current) { continue; }
+
+                // velocities travel with the actor, contacts are rebuilt
+                scene->removeActor(*actor, false);
+                m_Regions[target].Scene->addActor(*actor);
+            }
+        }
+
+        // region index of the new actor, -1 on failure
+        EMPY_INLINE int32_t CreateActor(Entity& entity)
+        {                   
             auto& body = entity.template Get<RigidBodyComponent>().RigidBody;
-            bool hasCollider = entity.template Has<ColliderComponent>();
 
             // create rigidbody transformation
-            PxTransform pose(ToPxVec3(transform.Translate)); 
-            glm::quat rot(transform.Rotation);
-            pose.q = PxQuat(rot.x, rot.y, rot.z, rot.w);
+            glm::vec3 scale;
+            auto pose = WorldPose(entity, scale);
+
+            // resolved first, a new region copies existing statics
+            auto region = RegionAt(pose.p);
 
             // create a rigid body actor
             if(entity.template Has<ColliderComponent>())
@@ -71,25 +583,24 @@ namespace Empy
                 // get collider component
                 auto& collider = entity.template Get<ColliderComponent>().Collider;
                 
-                // create collider material
-                collider.Material = m_Physics->createMaterial(collider.StaticFriction, 
-                    collider.DynamicFriction, collider.Restitution
-                );
-
-                if(collider.Type == ColliderType::BOX)
+                // triangle meshes can't simulate dynamically
+                auto type = collider.Type;
+                if(type == ColliderType::MESH && body.Dynamic)
                 {
-                    PxBoxGeometry box(ToPxVec3(transform.Scale/2.0f));
-                    collider.Shape = m_Physics->createShape(box, *collider.Material);
+                    EMPY_WARN("mesh collider on dynamic body, using convex hull");
+                    type = ColliderType::CONVEX;
                 }
-                else if(collider.Type == ColliderType::SPHERE)
-                {
-                    PxSphereGeometry sphere(transform.Scale.x/2.0f);
-                    collider.Shape = m_Physics->createShape(sphere, *collider.Material);
-                }                       
-                else
+
+                // identical colliders share material and shape
+                PxBase* mesh = CookCollider(collider, type);
+                collider.Material = m_Cache.AcquireMaterial(collider);
+                collider.Shape = collider.Material ? m_Cache.AcquireShape(type, scale, 
+                    collider.Material, mesh, FilterData(entity.ID(), collider)) : nullptr;
+
+                if(!collider.Shape)
                 {
                     EMPY_ERROR("Error creating collider invalid type provided");
-                    return;
+                    return -1;
                 }
 
                 // create actor
@@ -119,67 +630,221 @@ namespace Empy
             if (!body.Actor) 
             {
                 EMPY_ERROR("Error creating dynamic actor");               
-                return;
+                return -1;
             }
 
-            // set user data to entt id
-            body.Actor->userData = new EntityID(entity.ID()); 
+            // entt id stored in the pointer value
+            body.Actor->userData = PxToUserData(entity.ID()); 
 
-            // add actor to the m_Scene
-            m_Scene->addActor(*body.Actor);               
+            // initial interpolation poses
+            body.Previous = body.Current = pose;
+            ReplicateStatic(body.Actor, region);
+            return static_cast<int32_t>(region);
         }
-        
-        EMPY_INLINE void Simulate(uint32_t step, float dt)
+
+        // pose and scale of the world matrix, local transform outside the hierarchy
+        EMPY_INLINE PxTransform WorldPose(Entity& entity, glm::vec3& scale) const
         {
-            for (int i = 0; i < step; ++i) 
+            auto& transform = entity.template Get<TransformComponent>().Transform;
+            auto world = m_Registry->try_get<WorldMatrixComponent>(entity.ID());
+            if(!world)
             {
-                // simulate m_Physics for a time step
-                m_Scene->simulate(dt); 
-                // block until simulation is complete
-                m_Scene->fetchResults(true); 
+                auto rot = transform.Quaternion();
+                scale = transform.Scale;
+                return PxTransform(ToPxVec3(transform.Translate), PxQuat(rot.x, rot.y, rot.z, rot.w));
             }
+
+            // shear is dropped, physx poses are rigid
+            auto& matrix = world->Matrix;
+            scale = glm::vec3(glm::length(glm::vec3(matrix[0])), 
+                glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2])));
+            auto axes = glm::max(scale, glm::vec3(1e-6f));
+            auto basis = glm::mat3(glm::vec3(matrix[0]) / axes.x, 
+                glm::vec3(matrix[1]) / axes.y, glm::vec3(matrix[2]) / axes.z);
+            auto rot = glm::quat_cast(basis);
+            return PxTransform(ToPxVec3(glm::vec3(matrix[3])), PxQuat(rot.x, rot.y, rot.z, rot.w));
         }
 
-        EMPY_INLINE void SetEventCallback(PxCallbackFunction&& callback)
+        // takes over a deserialized actor, returns its region
+        EMPY_INLINE uint32_t AdoptActor(Entity& entity, PxRigidActor* actor)
         {
-            m_EventCallback.m_Callback = callback;
+            auto& body = entity.template Get<RigidBodyComponent>().RigidBody;
+            auto pose = actor->getGlobalPose();
+            auto region = RegionAt(pose.p);
+
+            actor->userData = PxToUserData(entity.ID());
+            body.Previous = body.Current = pose;
+            body.Actor = actor;
+
+            // loaded shape and material join the shared cache
+            PxShape* shape = nullptr;
+            if(entity.template Has<ColliderComponent>() && actor->getShapes(&shape, 1u))
+            {
+                auto& collider = entity.template Get<ColliderComponent>().Collider;
+                auto type = collider.Type;
+                if(type == ColliderType::MESH && body.Dynamic) { type = ColliderType::CONVEX; }
+
+                PxMaterial* material = nullptr;
+                shape->getMaterials(&material, 1u);
+                if(material) { m_Cache.Adopt(material, collider); }
+                glm::vec3 scale;
+                WorldPose(entity, scale);
+                m_Cache.Adopt(shape, type, scale, material);
+                collider.Material = material;
+                collider.Shape = shape;
+            }
+
+            ReplicateStatic(actor, region);
+            return region;
         }
 
-        EMPY_INLINE PxConvexMeshGeometry CookMesh(const MeshData<ShadedVertex>& data) 
-        {          
-            // px vertex container
-            std::vector<PxVec3> vertices;
+        // statics spanning borders exist in every region they touch
+        EMPY_INLINE void ReplicateStatic(PxRigidActor* actor, uint32_t home)
+        {
+            if(m_RegionSize <= 0.0f || !actor->is<PxRigidStatic>()) { return; }
+            for(uint32_t i = 0u; i < m_Regions.size(); i++)
+            {
+                if(i != home) { Replicate(actor, i); }
+            }
+        }
 
-            // convert position attributes
-            for(auto& vertex : data.Vertices)
+        // word0 layer bit, word1 mask, word2 layer, word3 report flag
+        EMPY_INLINE PxFilterData FilterData(EntityID entity, const Collider3D& collider) const
+        {
+            auto layer = std::min(collider.Layer, PxLayerMatrix::MAX_LAYERS - 1u);
+            auto report = static_cast<PxU32>(m_Subscribers.count(entity));
+            return PxFilterData(1u << layer, collider.Mask, layer, report);
+        }
+
+        // replaces body shape after filter inputs changed
+        EMPY_INLINE void RefreshFilter(EntityID entity)
+        {
+            if(!m_Registry->valid(entity)) { return; }
+            auto body = m_Registry->try_get<RigidBodyComponent>(entity);
+            auto comp = m_Registry->try_get<ColliderComponent>(entity);
+            if(!body || !comp || !body->RigidBody.Actor || !comp->Collider.Shape) { return; }
+
+            auto& collider = comp->Collider;
+            auto shape = m_Cache.AcquireFiltered(collider.Shape, FilterData(entity, collider));
+            if(!shape) { return; }
+
+            if(shape != collider.Shape)
+            {
+                body->RigidBody.Actor->detachShape(*collider.Shape);
+                body->RigidBody.Actor->attachShape(*shape);
+                auto itr = m_Clones.find(body->RigidBody.Actor);
+                for(size_t i = 0u; itr != m_Clones.end() && i < itr->second.size(); i++)
+                {
+                    itr->second[i]->detachShape(*collider.Shape);
+                    itr->second[i]->attachShape(*shape);
+                }
+            }
+            m_Cache.Release(collider.Shape);
+            collider.Shape = shape;
+        }
+
+        // uploads matrix, existing pairs are filtered again
+        EMPY_INLINE void UpdateLayers()
+        {
+            for(auto& region : m_Regions)
             {
-                vertices.push_back(ToPxVec3(vertex.Position));
+                region.Scene->setFilterShaderData(&m_Layers, sizeof(PxLayerMatrix));
             }
 
-            PxConvexMeshDesc meshDesc;
-            // vertices
-            meshDesc.points.data = vertices.data();
-            meshDesc.points.stride = sizeof(PxVec3);
-            meshDesc.points.count = vertices.size();
-            // indices 
-            meshDesc.indices.data = data.Indices.data();
-            meshDesc.indices.count = data.Indices.size();
-            // flags
-            meshDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+            auto reset = [] (PxRigidActor* actor)
+            {
+                if(actor->getScene()) { actor->getScene()->resetFiltering(*actor); }
+            };
 
-            // cooking the mesh
-            PxCookingParams cookingParams = PxCookingParams(PxTolerancesScale());    
-            PxCooking* cooking = PxCreateCooking(PX_PHYSICS_VERSION, *m_Foundation, cookingParams);
-            PxConvexMeshCookingResult::Enum result;            
-            PxConvexMesh* convexMesh = cooking->createConvexMesh(meshDesc, 
-            m_Physics->getPhysicsInsertionCallback(), &result);
-            PxConvexMeshGeometry convexMeshGeometry(convexMesh);
+            for(auto [entity, comp] : m_Registry->view<RigidBodyComponent>().each())
+            {
+                if(comp.RigidBody.Actor) { reset(comp.RigidBody.Actor); }
+            }
 
-            cooking->release();
-            return convexMeshGeometry;
+            for(auto& [actor, clones] : m_Clones)
+            {
+                for(auto clone : clones) { reset(clone); }
+            }
+        }
+
+        // cooked mesh of collider model, null for primitives
+        EMPY_INLINE PxBase* CookCollider(const Collider3D& collider, ColliderType type)
+        {
+            if(type != ColliderType::MESH && type != ColliderType::CONVEX) { return nullptr; }
+
+            auto& model = m_Assets->Get<ModelAsset>(collider.Model);
+            if(!model.Data || model.Data->Collision().Vertices.empty())
+            {
+                EMPY_ERROR("mesh collider without model geometry!");
+                return nullptr;
+            }
+
+            auto& data = model.Data->Collision();
+            if(type == ColliderType::MESH) { return m_Cooker.Triangles(data); }
+            return m_Cooker.Convex(data);
+        }
+
+        // detaches shape from a live body, gives back shared refs
+        EMPY_INLINE void OnDestroyCollider(EntityRegistry& registry, EntityID entity)
+        {
+            auto& collider = registry.get<ColliderComponent>(entity).Collider;
+            auto comp = registry.try_get<RigidBodyComponent>(entity);
+            auto actor = comp ? comp->RigidBody.Actor : nullptr;
+            if(actor && collider.Shape)
+            {
+                actor->detachShape(*collider.Shape);
+                auto itr = m_Clones.find(actor);
+                for(size_t i = 0u; itr != m_Clones.end() && i < itr->second.size(); i++)
+                {
+                    itr->second[i]->detachShape(*collider.Shape);
+                }
+            }
+            ReleaseCollider(collider);
+        }
+
+        // shared refs held by collider, null afterwards
+        EMPY_INLINE void ReleaseCollider(Collider3D& collider)
+        {
+            if(collider.Shape) { m_Cache.Release(collider.Shape); }
+            if(collider.Material) { m_Cache.Release(collider.Material); }
+            collider.Material = nullptr;
+            collider.Shape = nullptr;
+        }
+
+        EMPY_INLINE void OnScriptAdded(EntityRegistry&, EntityID entity)
+        {
+            Subscribe(entity);
+        }
+
+        EMPY_INLINE void OnScriptRemoved(EntityRegistry&, EntityID entity)
+        {
+            Subscribe(entity, false);
+        }
+
+        // releases actor and shared collider data, physics must be idle
+        EMPY_INLINE void OnDestroyBody(EntityRegistry& registry, EntityID entity)
+        {
+            auto& body = registry.get<RigidBodyComponent>(entity).RigidBody;
+            m_Subscribers.erase(entity);
+            if(!body.Actor) { return; }
+
+            auto itr = m_Clones.find(body.Actor);
+            if(itr != m_Clones.end())
+            {
+                for(auto clone : itr->second) { clone->release(); }
+                m_Clones.erase(itr);
+            }
+
+            body.Actor->release();
+            body.Actor = nullptr;
+
+            // body removed alone, collider acquires again with the next actor
+            if(auto collider = registry.try_get<ColliderComponent>(entity))
+            {
+                ReleaseCollider(collider->Collider);
+            }
         }
 
-    private:
         // custom collision filter shader callback
         static PxFilterFlags CustomFilterShader
         (
@@ -188,20 +853,110 @@ namespace Empy
             PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize
         )
         {
-            // generate contacts and triggers for actors
-            pairFlags |= PxPairFlag::eCONTACT_DEFAULT | 
-            PxPairFlag::eTRIGGER_DEFAULT;
+            auto layers = static_cast<const PxLayerMatrix*>(constantBlock);
+
+            // both masks must accept the other layer
+            if (!(filterData0.word0 & filterData1.word1) || !(filterData1.word0 & filterData0.word1))
+            {
+                return PxFilterFlag::eKILL;
+            }
+
+            // layer interaction matrix
+            if (!layers->Collides(filterData0.word2, filterData1.word2))
+            {
+                return PxFilterFlag::eKILL;
+            }
+
+            // notify only if a subscriber or report layer is involved
+            bool report = (filterData0.word3 || filterData1.word3 ||
+                (layers->Report & (filterData0.word0 | filterData1.word0)));
 
+            // triggers exist only to report
+            if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1))
+            {
+                if (!report) { return PxFilterFlag::eSUPPRESS; }
+                pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
+                return PxFilterFlag::eDEFAULT;
+            }
+
+            // generate contacts, points and impulses when reported
+            pairFlags = PxPairFlag::eCONTACT_DEFAULT;
+            if (report)
+            {
+                pairFlags |= PxPairFlag::eNOTIFY_TOUCH_FOUND | 
+                PxPairFlag::eNOTIFY_CONTACT_POINTS;
+            }
             return PxFilterFlag::eDEFAULT;
         }
 
+        // helps the job system while physx tasks are pending
+        EMPY_INLINE void WaitResults(PxScene* scene)
+        {
+            while(!scene->checkResults(false))
+            {
+                if(!m_Jobs->Help()) { std::this_thread::yield(); }
+            }
+            scene->fetchResults(true);
+        }
+
+        // appends awake actors, unique across substeps
+        EMPY_INLINE void CollectActiveActors(PxScene* scene)
+        {
+            PxU32 count = 0u;
+            auto actors = scene->getActiveActors(count);
+            m_ActiveEntities.reserve(m_ActiveEntities.size() + count);
+
+            for(PxU32 i = 0u; i < count; i++)
+            {
+                if(!actors[i]->userData) { continue; }
+                m_ActiveEntities.push_back(PxToEntity(actors[i]->userData));
+            }
+
+            std::sort(m_ActiveEntities.begin(), m_ActiveEntities.end());
+            m_ActiveEntities.erase(std::unique(m_ActiveEntities.begin(), 
+                m_ActiveEntities.end()), m_ActiveEntities.end());
+        }
+
     private:
+        std::unordered_map<PxRigidActor*, std::vector<PxRigidActor*>> m_Clones;
+        std::unordered_map<uint64_t, uint32_t> m_RegionMap;
+        std::unordered_set<EntityID> m_Subscribers;
+        std::vector<EntityID> m_ActiveEntities;
+        std::vector<PxRegion> m_Regions;
+        PxLayerMatrix m_Layers;
+
+        // spatial regions, size zero disables
+        float m_RegionMargin = 0.0f;
+        float m_RegionSize = 0.0f;
+
+        // fixed time step
+        double m_Accumulator = 0.0;
+        float m_TimeStep = 1.0f / 60.0f;
+        float m_StepTime = 0.0f;
+        uint32_t m_MaxSubSteps = 4u;
+        uint32_t m_Steps = 0u;
+        float m_Alpha = 1.0f;
+        bool m_FixedStep = true;
+
+        // async stepping
+        bool m_Simulating = false;
+        // fetched async step not yet taken
+        bool m_Pending = false;
+        bool m_Async = false;
+
         PxDefaultErrorCallback m_ErrorCallback;
         PxDefaultAllocator m_AllocatorCallback;
-        PxDefaultCpuDispatcher* m_Dispatcher;
         PxEventCallback m_EventCallback;      
+        PxJobDispatcher m_Dispatcher;
+        EntityRegistry* m_Registry;
+        AssetRegistry* m_Assets;
+        PxQueryService m_Queries;
+        PxSceneSnapshot m_Snapshot;
+        PxColliderCache m_Cache;
+        PxMeshCooker m_Cooker;
         PxFoundation* m_Foundation;
         PxPhysics* m_Physics;
         PxScene* m_Scene;
+        JobSystem* m_Jobs;
     };
 }
\ No newline at end of file
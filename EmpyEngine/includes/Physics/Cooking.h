@@ -0,0 +1,189 @@
+#pragma once
+#include "Utilities.h"
+#include "Graphics/Buffers/Vertex.h"
+
+namespace Empy
+{
+    // cooks collision meshes, streams cached on disk by content hash
+    struct PxMeshCooker
+    {
+        EMPY_INLINE PxMeshCooker() = default;
+
+        EMPY_INLINE void Init(PxFoundation* foundation, PxPhysics* physics, const std::string& directory)
+        {
+            // one cooking instance for all meshes
+            m_Params = PxCookingParams(physics->getTolerancesScale());
+            m_Cooking = PxCreateCooking(PX_PHYSICS_VERSION, *foundation, m_Params);
+            m_Directory = directory;
+            m_Physics = physics;
+
+            std::error_code error;
+            std::filesystem::create_directories(m_Directory, error);
+            if(error) { EMPY_WARN("cooking cache disabled: {}", error.message()); }
+        }
+
+        // convex hull of the positions
+        EMPY_INLINE PxConvexMesh* Convex(const CollisionData& data)
+        {
+            auto hash = Hash(data, PxConcreteType::eCONVEX_MESH);
+            if(auto itr = m_Meshes.find(hash); itr != m_Meshes.end())
+            {
+                return static_cast<PxConvexMesh*>(itr->second);
+            }
+
+            auto cook = [this, &data] (PxDefaultMemoryOutputStream& output)
+            {
+                PxConvexMeshDesc desc;
+                desc.points.data = data.Vertices.data();
+                desc.points.stride = sizeof(glm::vec3);
+                desc.points.count = static_cast<PxU32>(data.Vertices.size());
+                desc.flags = CONVEX_FLAGS;
+
+                if(m_Cooking && m_Cooking->cookConvexMesh(desc, output)) { return true; }
+                EMPY_ERROR("failed to cook convex mesh!");
+                return false;
+            };
+
+            return static_cast<PxConvexMesh*>(Build(hash, cook, [this] (PxInputStream& input) -> PxBase*
+            {
+                return m_Physics->createConvexMesh(input);
+            }));
+        }
+
+        // triangle mesh, static and kinematic actors only
+        EMPY_INLINE PxTriangleMesh* Triangles(const CollisionData& data)
+        {
+            auto hash = Hash(data, PxConcreteType::eTRIANGLE_MESH_BVH33);
+            if(auto itr = m_Meshes.find(hash); itr != m_Meshes.end())
+            {
+                return static_cast<PxTriangleMesh*>(itr->second);
+            }
+
+            auto cook = [this, &data] (PxDefaultMemoryOutputStream& output)
+            {
+                PxTriangleMeshDesc desc;
+                desc.points.data = data.Vertices.data();
+                desc.points.stride = sizeof(glm::vec3);
+                desc.points.count = static_cast<PxU32>(data.Vertices.size());
+                desc.triangles.data = data.Indices.data();
+                desc.triangles.stride = 3u * sizeof(uint32_t);
+                desc.triangles.count = static_cast<PxU32>(data.Indices.size() / 3u);
+
+                if(m_Cooking && m_Cooking->cookTriangleMesh(desc, output)) { return true; }
+                EMPY_ERROR("failed to cook triangle mesh!");
+                return false;
+            };
+
+            return static_cast<PxTriangleMesh*>(Build(hash, cook, [this] (PxInputStream& input) -> PxBase*
+            {
+                return m_Physics->createTriangleMesh(input);
+            }));
+        }
+
+        // hash of the cooking inputs that are not geometry
+        EMPY_INLINE uint64_t Fingerprint() const
+        {
+            return Hash(CollisionData(), 0u);
+        }
+
+        // releases meshes and cooking, call before physics is released
+        EMPY_INLINE void Clear()
+        {
+            for(auto& [hash, mesh] : m_Meshes) { mesh->release(); }
+            if(m_Cooking) { m_Cooking->release(); }
+            m_Cooking = nullptr;
+            m_Meshes.clear();
+        }
+
+    private:
+        // geometry, mesh type and everything that changes the cooked stream
+        EMPY_INLINE uint64_t Hash(const CollisionData& data, PxU16 type) const
+        {
+            auto scale = m_Physics->getTolerancesScale();
+            auto version = static_cast<uint32_t>(PX_PHYSICS_VERSION);
+            auto preprocess = static_cast<uint32_t>(m_Params.meshPreprocessParams);
+            auto flags = static_cast<uint32_t>(CONVEX_FLAGS);
+
+            uint64_t hash = HashBytes(data.Vertices.data(), data.Vertices.size() * sizeof(glm::vec3));
+            hash = HashBytes(data.Indices.data(), data.Indices.size() * sizeof(uint32_t), hash);
+            hash = HashBytes(&type, sizeof(type), hash);
+            hash = HashBytes(&version, sizeof(version), hash);
+            hash = HashBytes(&scale.length, sizeof(float), hash);
+            hash = HashBytes(&scale.speed, sizeof(float), hash);
+            hash = HashBytes(&preprocess, sizeof(preprocess), hash);
+            return HashBytes(&flags, sizeof(flags), hash);
+        }
+
+        // cached stream first, one physx rejects is deleted and cooked again
+        template <typename Cook, typename Create>
+        EMPY_INLINE PxBase* Build(uint64_t hash, Cook&& cook, Create&& create)
+        {
+            auto stream = Load(hash);
+            if(!stream.empty())
+            {
+                PxDefaultMemoryInputData input(stream.data(), static_cast<PxU32>(stream.size()));
+                if(auto mesh = create(input))
+                {
+                    m_Meshes[hash] = mesh;
+                    return mesh;
+                }
+
+                EMPY_WARN("corrupt cooking cache '{}', cooking again", CachePath(hash));
+                std::error_code error;
+                std::filesystem::remove(CachePath(hash), error);
+            }
+
+            PxDefaultMemoryOutputStream output;
+            if(!cook(output)) { return nullptr; }
+            stream.assign(output.getData(), output.getData() + output.getSize());
+
+            PxDefaultMemoryInputData input(stream.data(), static_cast<PxU32>(stream.size()));
+            auto mesh = create(input);
+            if(!mesh) { return nullptr; }
+
+            Store(hash, stream);
+            m_Meshes[hash] = mesh;
+            return mesh;
+        }
+
+        EMPY_INLINE std::string CachePath(uint64_t hash) const
+        {
+            std::stringstream name;
+            name << std::hex << hash << ".pxc";
+            return (std::filesystem::path(m_Directory) / name.str()).string();
+        }
+
+        // empty if not cached yet
+        EMPY_INLINE std::vector<PxU8> Load(uint64_t hash) const
+        {
+            std::ifstream file(CachePath(hash), std::ios::binary);
+            if(!file.is_open()) { return {}; }
+            return std::vector<PxU8>(std::istreambuf_iterator<char>(file), {});
+        }
+
+        // written aside and renamed, a crash never leaves a partial stream
+        EMPY_INLINE void Store(uint64_t hash, const std::vector<PxU8>& stream) const
+        {
+            auto path = CachePath(hash);
+            auto temp = path + ".tmp";
+            {
+                std::ofstream file(temp, std::ios::binary);
+                if(!file.is_open()) { return; }
+                file.write(reinterpret_cast<const char*>(stream.data()), stream.size());
+                if(!file) { return; }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temp, path, error);
+            if(error) { std::filesystem::remove(temp, error); }
+        }
+
+    private:
+        static constexpr PxConvexFlag::Enum CONVEX_FLAGS = PxConvexFlag::eCOMPUTE_CONVEX;
+        std::unordered_map<uint64_t, PxBase*> m_Meshes;
+        PxCooking* m_Cooking = nullptr;
+        PxPhysics* m_Physics = nullptr;
+        PxCookingParams m_Params = PxCookingParams(PxTolerancesScale());
+        std::string m_Directory;
+    };
+}
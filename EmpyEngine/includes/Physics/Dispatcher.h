@@ -0,0 +1,93 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include "Common/Jobs.h"
+
+using namespace physx;
+
+namespace Empy
+{
+    // time spent in one kind of physx task
+    struct PxTaskTiming
+    {
+        uint32_t Calls = 0u;
+        // accumulated (ms)
+        double Time = 0.0;
+    };
+
+    // runs physx tasks on the engine job system
+    struct PxJobDispatcher : PxCpuDispatcher
+    {
+        EMPY_INLINE PxJobDispatcher(JobSystem* jobs):
+            m_Timings(jobs->WorkerCount() + 1u), m_Jobs(jobs)
+        {}
+
+        EMPY_INLINE void submitTask(PxBaseTask& task) override
+        {
+            m_Jobs->Submit([this, &task] 
+            {
+                if(!m_Timing)
+                {
+                    task.run();
+                    task.release();
+                    return;
+                }
+
+                auto start = std::chrono::high_resolution_clock::now();
+                task.run();
+                auto end = std::chrono::high_resolution_clock::now();
+
+                // name must be read before release
+                auto& timing = m_Timings[JobSystem::ThreadIndex()][task.getName()];
+                timing.Time += std::chrono::duration<double, std::milli>(end - start).count();
+                timing.Calls++;
+                task.release();
+            });
+        }
+
+        EMPY_INLINE uint32_t getWorkerCount() const override
+        {
+            return m_Jobs->WorkerCount();
+        }
+
+        // enables per-task timing
+        EMPY_INLINE void SetTiming(bool timing)
+        {
+            m_Timing = timing;
+        }
+
+        // merged timings, call while physics is idle
+        template <typename Task>
+        EMPY_INLINE void ViewTimings(Task&& task)
+        {
+            std::unordered_map<std::string, PxTaskTiming> merged;
+            for(auto& timings : m_Timings)
+            {
+                for(auto& [name, timing] : timings)
+                {
+                    auto& total = merged[name];
+                    total.Calls += timing.Calls;
+                    total.Time += timing.Time;
+                }
+            }
+
+            for(auto& [name, timing] : merged)
+            {
+                task(name, timing);
+            }
+        }
+
+        EMPY_INLINE void ResetTimings()
+        {
+            for(auto& timings : m_Timings)
+            {
+                timings.clear();
+            }
+        }
+
+    private:
+        // one map per job thread, physx names are literals
+        std::vector<std::unordered_map<const char*, PxTaskTiming>> m_Timings;
+        bool m_Timing = false;
+        JobSystem* m_Jobs;
+    };
+}
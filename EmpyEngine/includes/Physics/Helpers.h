@@ -17,4 +17,27 @@ namespace Empy
     {
         return PxVec3(glmVec.x, glmVec.y, glmVec.z);
     }
+
+    // helper function to store entity in actor user data (0 stays null)
+    EMPY_INLINE void* PxToUserData(EntityID entity) 
+    {
+        auto value = static_cast<uintptr_t>(entt::to_integral(entity)) + 1u;
+        return reinterpret_cast<void*>(value);
+    }
+
+    // helper function to read entity from actor user data
+    EMPY_INLINE EntityID PxToEntity(const void* userData) 
+    {
+        auto value = reinterpret_cast<uintptr_t>(userData);
+        return userData ? static_cast<EntityID>(value - 1u) : NENTT;
+    }
+
+    // helper function to blend two poses (lerp, slerp)
+    EMPY_INLINE PxTransform PxInterpolate(const PxTransform& a, const PxTransform& b, float t) 
+    {
+        glm::quat qa(a.q.w, a.q.x, a.q.y, a.q.z);
+        glm::quat qb(b.q.w, b.q.x, b.q.y, b.q.z);
+        glm::quat q = glm::slerp(qa, qb, t);
+        return PxTransform(a.p + (b.p - a.p) * t, PxQuat(q.x, q.y, q.z, q.w));
+    }
 } 
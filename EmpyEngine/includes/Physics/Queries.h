@@ -0,0 +1,300 @@
+#pragma once
+#include "Helpers.h"
+#include "Common/Jobs.h"
+
+namespace Empy
+{
+    enum class PxQueryType : uint8_t
+    { 
+        RAYCAST = 0,
+        SWEEP, 
+        OVERLAP
+    };
+
+    // queued scene query, sweeps and overlaps use a sphere
+    struct PxQueryRequest
+    {
+        glm::vec3 Origin = glm::vec3(0.0f);
+        glm::vec3 Direction = glm::vec3(0.0f, 0.0f, -1.0f);
+        uint32_t Mask = 0xFFFFFFFFu;
+        float Distance = 0.0f;
+        float Radius = 0.0f;
+        PxQueryType Type;
+    };
+
+    // closest blocking hit of one request
+    struct PxQueryResult
+    {
+        glm::vec3 Normal = glm::vec3(0.0f);
+        glm::vec3 Point = glm::vec3(0.0f);
+        EntityID Entity = NENTT;
+        float Distance = 0.0f;
+        bool Hit = false;
+    };
+
+    // runs queued queries in parallel batches
+    struct PxQueryService
+    {
+        EMPY_INLINE PxQueryService() = default;
+
+        EMPY_INLINE void Init(JobSystem* jobs)
+        {
+            m_Jobs = jobs;
+        }
+
+        // queries reaching bounds are run against scene
+        EMPY_INLINE void AddScene(PxScene* scene, const PxBounds3& bounds)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Targets.push_back(std::make_unique<Target>());
+            m_Targets.back()->Bounds = bounds;
+            m_Targets.back()->Scene = scene;
+        }
+
+        // returns request id, result valid after next Execute()
+        EMPY_INLINE uint32_t Raycast(const glm::vec3& origin, const glm::vec3& direction, 
+            float distance, uint32_t mask = 0xFFFFFFFFu)
+        {
+            return Push({ origin, direction, mask, distance, 0.0f, PxQueryType::RAYCAST });
+        }
+
+        EMPY_INLINE uint32_t Sweep(const glm::vec3& origin, const glm::vec3& direction, 
+            float distance, float radius, uint32_t mask = 0xFFFFFFFFu)
+        {
+            return Push({ origin, direction, mask, distance, radius, PxQueryType::SWEEP });
+        }
+
+        EMPY_INLINE uint32_t Overlap(const glm::vec3& center, float radius, uint32_t mask = 0xFFFFFFFFu)
+        {
+            return Push({ center, glm::vec3(0.0f), mask, 0.0f, radius, PxQueryType::OVERLAP });
+        }
+
+        // result of last executed batch, empty for unknown ids
+        EMPY_INLINE const PxQueryResult& Result(uint32_t id) const
+        {
+            static const PxQueryResult sEmpty;
+            return (id < m_Results.size()) ? m_Results[id] : sEmpty;
+        }
+
+        // runs all pending requests, scenes must not be simulating
+        EMPY_INLINE void Execute()
+        {
+            // jobs helped while waiting may push, they go to the next batch
+            m_Running.clear();
+            m_Scenes.clear();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Running.swap(m_Requests);
+                for(auto& target : m_Targets) { m_Scenes.push_back(target.get()); }
+            }
+
+            m_Results.assign(m_Running.size(), PxQueryResult());
+            if(m_Running.empty()) { return; }
+
+            // requests of each scene split in chunks
+            m_Indices.clear();
+            m_Work.clear();
+            for(auto target : m_Scenes)
+            {
+                auto first = static_cast<uint32_t>(m_Indices.size());
+                for(uint32_t i = 0u; i < m_Running.size(); i++)
+                {
+                    if(Reaches(m_Running[i], target->Bounds)) { m_Indices.push_back(i); }
+                }
+
+                auto count = static_cast<uint32_t>(m_Indices.size()) - first;
+                auto chunks = (count + BATCH_SIZE - 1u) / BATCH_SIZE;
+                while(target->Batches.size() < chunks)
+                {
+                    target->Batches.push_back(CreateBatch(target->Scene));
+                }
+
+                for(uint32_t c = 0u; c < chunks; c++)
+                {
+                    auto begin = first + c * BATCH_SIZE;
+                    m_Work.push_back({ target->Batches[c].get(), begin, 
+                        std::min(first + count, begin + BATCH_SIZE) });
+                }
+            }
+
+            auto count = static_cast<uint32_t>(m_Work.size());
+            m_Jobs->ParallelFor(count, 1u, [this] (uint32_t begin, uint32_t end)
+            {
+                for(uint32_t i = begin; i < end; i++)
+                {
+                    RunBatch(m_Work[i]);
+                }
+            });
+
+            // closest hit across scenes wins
+            for(auto& work : m_Work)
+            {
+                for(uint32_t i = work.Begin; i < work.End; i++)
+                {
+                    auto& hit = work.Chunk->Hits[i - work.Begin];
+                    auto& result = m_Results[m_Indices[i]];
+                    if(hit.Hit && (!result.Hit || hit.Distance < result.Distance)) { result = hit; }
+                }
+            }
+        }
+
+        // releases batch queries, call before the scenes are released
+        EMPY_INLINE void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for(auto& target : m_Targets)
+            {
+                for(auto& batch : target->Batches)
+                {
+                    if(batch->Query) { batch->Query->release(); }
+                }
+            }
+            m_Targets.clear();
+            m_Scenes.clear();
+            m_Work.clear();
+        }
+
+    private:
+        static constexpr uint32_t BATCH_SIZE = 64u;
+
+        struct Batch
+        {
+            PxRaycastQueryResult Raycasts[BATCH_SIZE];
+            PxSweepQueryResult Sweeps[BATCH_SIZE];
+            PxOverlapQueryResult Overlaps[BATCH_SIZE];
+            // hits by chunk slot, slot of each query per type
+            PxQueryResult Hits[BATCH_SIZE];
+            uint32_t Slots[3][BATCH_SIZE];
+            PxBatchQuery* Query = nullptr;
+        };
+
+        struct Target
+        {
+            std::vector<std::unique_ptr<Batch>> Batches;
+            PxScene* Scene = nullptr;
+            PxBounds3 Bounds;
+        };
+
+        // chunk of m_Indices run by one batch
+        struct Work
+        {
+            Batch* Chunk;
+            uint32_t Begin;
+            uint32_t End;
+        };
+
+        // requests may come from any thread
+        EMPY_INLINE uint32_t Push(const PxQueryRequest& request)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Requests.push_back(request);
+            return static_cast<uint32_t>(m_Requests.size() - 1u);
+        }
+
+        // request extents overlap scene bounds
+        EMPY_INLINE static bool Reaches(const PxQueryRequest& request, const PxBounds3& bounds)
+        {
+            PxVec3 start = ToPxVec3(request.Origin);
+            PxVec3 end = start + ToPxVec3(request.Direction).getNormalized() * request.Distance;
+            PxBounds3 extent = PxBounds3::boundsOfPoints(start, end);
+            extent.fattenFast(request.Radius);
+            return extent.intersects(bounds);
+        }
+
+        EMPY_INLINE std::unique_ptr<Batch> CreateBatch(PxScene* scene)
+        {
+            auto batch = std::make_unique<Batch>();
+            PxBatchQueryDesc desc(BATCH_SIZE, BATCH_SIZE, BATCH_SIZE);
+            desc.queryMemory.userRaycastResultBuffer = batch->Raycasts;
+            desc.queryMemory.userSweepResultBuffer = batch->Sweeps;
+            desc.queryMemory.userOverlapResultBuffer = batch->Overlaps;
+            batch->Query = scene->createBatchQuery(desc);
+            return batch;
+        }
+
+        EMPY_INLINE void RunBatch(const Work& work)
+        {
+            auto& batch = *work.Chunk;
+            std::fill(batch.Hits, batch.Hits + BATCH_SIZE, PxQueryResult());
+            if(!batch.Query) { return; }
+            uint32_t counts[3] = { 0u, 0u, 0u };
+            const PxHitFlags flags = PxHitFlag::eDEFAULT;
+
+            for(uint32_t i = work.Begin; i < work.End; i++)
+            {
+                auto& request = m_Running[m_Indices[i]];
+                auto type = static_cast<uint32_t>(request.Type);
+                batch.Slots[type][counts[type]++] = i - work.Begin;
+
+                // word0 is tested against the shape layer bit
+                PxQueryFilterData filter(PxFilterData(request.Mask, 0u, 0u, 0u), 
+                    PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC);
+                PxTransform pose(ToPxVec3(request.Origin));
+                PxVec3 direction = ToPxVec3(request.Direction).getNormalized();
+
+                if(request.Type == PxQueryType::RAYCAST)
+                {
+                    batch.Query->raycast(pose.p, direction, request.Distance, 0u, flags, filter);
+                }
+                else if(request.Type == PxQueryType::SWEEP)
+                {
+                    batch.Query->sweep(PxSphereGeometry(request.Radius), pose, direction, 
+                        request.Distance, 0u, flags, filter);
+                }
+                else
+                {
+                    filter.flags |= PxQueryFlag::eANY_HIT;
+                    batch.Query->overlap(PxSphereGeometry(request.Radius), pose, 0u, filter);
+                }
+            }
+            batch.Query->execute();
+
+            // copy blocking hits to their chunk slot
+            for(uint32_t k = 0u; k < counts[0]; k++)
+            {
+                auto& query = batch.Raycasts[k];
+                if(!query.hasBlock) { continue; }
+                auto& result = batch.Hits[batch.Slots[0][k]];
+                SetHit(result, query.block.actor, query.block.distance);
+                result.Point = PxToVec3(query.block.position);
+                result.Normal = PxToVec3(query.block.normal);
+            }
+
+            for(uint32_t k = 0u; k < counts[1]; k++)
+            {
+                auto& query = batch.Sweeps[k];
+                if(!query.hasBlock) { continue; }
+                auto& result = batch.Hits[batch.Slots[1][k]];
+                SetHit(result, query.block.actor, query.block.distance);
+                result.Point = PxToVec3(query.block.position);
+                result.Normal = PxToVec3(query.block.normal);
+            }
+
+            for(uint32_t k = 0u; k < counts[2]; k++)
+            {
+                auto& query = batch.Overlaps[k];
+                if(!query.hasBlock) { continue; }
+                SetHit(batch.Hits[batch.Slots[2][k]], query.block.actor, 0.0f);
+            }
+        }
+
+        EMPY_INLINE static void SetHit(PxQueryResult& result, const PxRigidActor* actor, float distance)
+        {
+            result.Entity = actor ? PxToEntity(actor->userData) : NENTT;
+            result.Distance = distance;
+            result.Hit = true;
+        }
+
+    private:
+        std::vector<std::unique_ptr<Target>> m_Targets;
+        std::vector<PxQueryRequest> m_Requests;
+        // requests and scenes of the batch being executed
+        std::vector<PxQueryRequest> m_Running;
+        std::vector<Target*> m_Scenes;
+        std::vector<PxQueryResult> m_Results;
+        std::vector<uint32_t> m_Indices;
+        std::vector<Work> m_Work;
+        JobSystem* m_Jobs = nullptr;
+        std::mutex m_Mutex;
+    };
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include "Helpers.h"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Empy
+{
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x42585045u;
+
+    // precedes the collection, padded to the serialization alignment
+    struct alignas(PX_SERIAL_FILE_ALIGN) SnapshotHeader
+    {
+        uint32_t Magic = SNAPSHOT_MAGIC;
+        uint64_t Key = 0u;
+    };
+
+    // binary physx collections, loaded in place from disk
+    struct PxSceneSnapshot
+    {
+        EMPY_INLINE PxSceneSnapshot() = default;
+
+        EMPY_INLINE void Init(PxPhysics* physics)
+        {
+            m_Physics = physics;
+        }
+
+        // writes objects and everything they reference, ids must be unique,
+        // key hashes the inputs the actors were built from
+        EMPY_INLINE bool Save(const std::vector<std::pair<PxBase*, PxSerialObjectId>>& objects,
+            const std::string& path, uint64_t key)
+        {
+            auto registry = PxSerialization::createSerializationRegistry(*m_Physics);
+            auto collection = PxCreateCollection();
+
+            for(auto& [object, id] : objects)
+            {
+                if(id != PX_SERIAL_OBJECT_ID_INVALID) { collection->add(*object, id); }
+            }
+            PxSerialization::complete(*collection, *registry);
+
+            bool saved = false;
+            PxDefaultFileOutputStream output(path.c_str());
+            if(output.isValid())
+            {
+                SnapshotHeader header;
+                header.Key = key;
+                saved = (output.write(&header, sizeof(header)) == sizeof(header)) &&
+                    PxSerialization::serializeCollectionToBinary(output, *collection, *registry);
+            }
+            if(!saved) { EMPY_ERROR("failed to write physics snapshot: {}", path); }
+
+            collection->release();
+            registry->release();
+            return saved;
+        }
+
+        // objects live in the mapped file until Clear(), null on failure or other key
+        EMPY_INLINE PxCollection* Load(const std::string& path, uint64_t key)
+        {
+            size_t size = 0u;
+            void* memory = Map(path, size);
+            if(!memory) { return nullptr; }
+
+            auto header = static_cast<const SnapshotHeader*>(memory);
+            if(size <= sizeof(SnapshotHeader) || header->Magic != SNAPSHOT_MAGIC || header->Key != key)
+            {
+                Unmap(memory, size);
+                return nullptr;
+            }
+
+            // header size keeps the collection aligned
+            auto registry = PxSerialization::createSerializationRegistry(*m_Physics);
+            auto data = static_cast<uint8_t*>(memory) + sizeof(SnapshotHeader);
+            auto collection = PxSerialization::createCollectionFromBinary(data, *registry);
+            registry->release();
+
+            if(!collection)
+            {
+                EMPY_WARN("outdated or corrupt physics snapshot: {}", path);
+                Unmap(memory, size);
+                return nullptr;
+            }
+            m_Blocks.emplace_back(memory, size);
+            return collection;
+        }
+
+        // frees snapshot memory, call after physics is released
+        EMPY_INLINE void Clear()
+        {
+            for(auto& [memory, size] : m_Blocks) { Unmap(memory, size); }
+            m_Blocks.clear();
+        }
+
+    private:
+        // private writable pages, physx patches pointers in place
+        EMPY_INLINE static void* Map(const std::string& path, size_t& size)
+        {
+            std::error_code error;
+            size = static_cast<size_t>(std::filesystem::file_size(path, error));
+            if(error || size == 0u) { return nullptr; }
+
+        #if defined(__linux__)
+            int file = open(path.c_str(), O_RDONLY);
+            if(file < 0) { return nullptr; }
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            close(file);
+            return (memory != MAP_FAILED) ? memory : nullptr;
+        #else
+            std::ifstream stream(path, std::ios::binary);
+            if(!stream) { return nullptr; }
+            void* memory = ::operator new(size, std::align_val_t(PX_SERIAL_FILE_ALIGN));
+            if(!stream.read(static_cast<char*>(memory), size))
+            {
+                Unmap(memory, size);
+                return nullptr;
+            }
+            return memory;
+        #endif
+        }
+
+        EMPY_INLINE static void Unmap(void* memory, size_t size)
+        {
+        #if defined(__linux__)
+            munmap(memory, size);
+        #else
+            ::operator delete(memory, std::align_val_t(PX_SERIAL_FILE_ALIGN));
+        #endif
+        }
+
+    private:
+        std::vector<std::pair<void*, size_t>> m_Blocks;
+        PxPhysics* m_Physics = nullptr;
+    };
+}
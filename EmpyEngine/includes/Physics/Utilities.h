@@ -11,6 +11,10 @@ namespace Empy
         PxRigidActor* Actor = nullptr;
         float Density = 1.0f;
         bool Dynamic = true;
+
+        // poses around the last fixed step
+        PxTransform Previous = PxTransform(PxIdentity);
+        PxTransform Current = PxTransform(PxIdentity);
     };
 
     // collider shape type
@@ -20,9 +24,43 @@ namespace Empy
         CAPSULE,
         SPHERE, 
         MESH, 
-        BOX
+        BOX,
+        CONVEX
     };    
 
+    // layer interaction matrix, read by the filter shader
+    struct PxLayerMatrix
+    {
+        static constexpr uint32_t MAX_LAYERS = 32u;
+
+        EMPY_INLINE PxLayerMatrix()
+        {
+            for(auto& row : Collide) { row = 0xFFFFFFFFu; }
+        }
+
+        EMPY_INLINE void Set(uint32_t a, uint32_t b, bool collide)
+        {
+            if(collide)
+            {
+                Collide[a] |= (1u << b);
+                Collide[b] |= (1u << a);
+                return;
+            }
+            Collide[a] &= ~(1u << b);
+            Collide[b] &= ~(1u << a);
+        }
+
+        EMPY_INLINE bool Collides(uint32_t a, uint32_t b) const
+        {
+            return (Collide[a] & (1u << b)) != 0u;
+        }
+
+        // bit b of row a, symmetric
+        uint32_t Collide[MAX_LAYERS];
+        // layers whose pairs always report contacts
+        uint32_t Report = 0u;
+    };
+
     struct Collider3D
     {
         EMPY_INLINE Collider3D(const Collider3D&) = default;
@@ -33,9 +71,14 @@ namespace Empy
         float StaticFriction = 0.3f;
         float Restitution = 0.4f;
 
-        // mesh for custom shape
+        // model asset for mesh and convex shapes
+        uint64_t Model = 0u;
+
+        // layer index and layers it may touch
+        uint32_t Mask = 0xFFFFFFFFu;
+        uint32_t Layer = 0u;
+
         PxMaterial* Material = nullptr;
-        PxConvexMeshGeometry Mesh;
         PxShape* Shape = nullptr;    
         ColliderType Type;        
     };
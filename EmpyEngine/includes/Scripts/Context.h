@@ -1,12 +1,31 @@
 #pragma once
 #include "Window/Window.h"
 #include "Auxiliaries/ECS.h"
+#include "Physics/Queries.h"
 
 namespace Empy
 {
+    // euler angles of a transform, component writes go through SetEuler
+    struct EulerProxy
+    {
+        EMPY_INLINE float Get(int32_t axis) const
+        {
+            return Transform->Euler()[axis];
+        }
+
+        EMPY_INLINE void Set(int32_t axis, float value)
+        {
+            auto euler = Transform->Euler();
+            euler[axis] = value;
+            Transform->SetEuler(euler);
+        }
+
+        Transform3D* Transform = nullptr;
+    };
+
     struct ScriptContext
     {
-        EMPY_INLINE ScriptContext(EntityRegistry* scene, AppWindow* window)
+        EMPY_INLINE ScriptContext(EntityRegistry* scene, AppWindow* window, PxQueryService* queries)
         {       
             // import lua libraries
             m_Lua.open_libraries(sol::lib::base);
@@ -18,10 +37,18 @@ namespace Empy
             // runtime type identifiers
             m_Lua["TRANSFORM"] = TypeID<TransformComponent>();
 
+            // rotation.x = v must reach the transform, a vec3 copy would drop it
+            m_Lua.new_usertype<EulerProxy>("EulerAngles",
+                "x", sol::property([] (EulerProxy& e) { return e.Get(0); }, [] (EulerProxy& e, float v) { e.Set(0, v); }),
+                "y", sol::property([] (EulerProxy& e) { return e.Get(1); }, [] (EulerProxy& e, float v) { e.Set(1, v); }),
+                "z", sol::property([] (EulerProxy& e) { return e.Get(2); }, [] (EulerProxy& e, float v) { e.Set(2, v); })
+            );
+
             // add transform data type
             m_Lua.new_usertype<Transform3D>("Transform3D",
                 "Translate", &Transform3D::Translate,
-                "Rotation", &Transform3D::Rotation,
+                "Rotation", sol::property([] (Transform3D& t) { return EulerProxy{ &t }; }, 
+                    [] (Transform3D& t, const glm::vec3& euler) { t.SetEuler(euler); }),
                 "Scale", &Transform3D::Scale
             );
 
@@ -35,8 +62,16 @@ namespace Empy
 
             // register window inputs callbacks      
             SetApiFunctions(scene, window);       
+            SetQueryFunctions(queries);
+            SetProfileFunctions();
         }
         
+        // bytes held by the lua state
+        EMPY_INLINE size_t MemoryUsed() const
+        {
+            return m_Lua.memory_used();
+        }
+
         // creates instance of existing script
         EMPY_INLINE bool AttachScript(Entity& entity, const std::string& name)
         {                    
@@ -148,25 +183,6 @@ namespace Empy
                 // return if entity is dead!
                 if(scene->valid(entity) == false) { return; }
                                
-                // entity has rigidbody component                
-                if(scene->all_of<RigidBodyComponent>(entity)) 
-                {
-                    // destroy actor user data      
-                    auto& body = scene->get<RigidBodyComponent>(entity).RigidBody;     
-                    auto userData = static_cast<EntityID*>(body.Actor->userData);
-                    body.Actor->release();
-                    EMPY_DELETE(userData);
-                } 
-
-                // destroy collider material & shape
-                if(scene->all_of<ColliderComponent>(entity)) 
-                {
-                    // destroy actor user data      
-                    auto& collider = scene->get<ColliderComponent>(entity).Collider;     
-                    collider.Material->release();
-                    collider.Shape->release();
-                }                
-
                 // entity has script component
                 if(scene->all_of<ScriptComponent>(entity)) 
                 {
@@ -174,11 +190,55 @@ namespace Empy
                     scene->get<ScriptComponent>(entity).Instance->OnDestroy();     
                 }
 
-                // destroy entity from scene
+                // physics releases actor and collider on destroy
                 scene->destroy(entity);
             });
         }
 
+        // registers batched scene queries, results arrive next frame
+        EMPY_INLINE void SetQueryFunctions(PxQueryService* queries)
+        {
+            m_Lua.set_function("ApiRaycast", [queries] (const glm::vec3& origin, 
+                const glm::vec3& direction, float distance, sol::optional<uint32_t> mask)
+            {
+                return queries->Raycast(origin, direction, distance, mask.value_or(0xFFFFFFFFu));
+            });
+
+            m_Lua.set_function("ApiSweep", [queries] (const glm::vec3& origin, 
+                const glm::vec3& direction, float distance, float radius, sol::optional<uint32_t> mask)
+            {
+                return queries->Sweep(origin, direction, distance, radius, mask.value_or(0xFFFFFFFFu));
+            });
+
+            m_Lua.set_function("ApiOverlap", [queries] (const glm::vec3& center, 
+                float radius, sol::optional<uint32_t> mask)
+            {
+                return queries->Overlap(center, radius, mask.value_or(0xFFFFFFFFu));
+            });
+
+            // multiple returns, no table per hit
+            m_Lua.set_function("ApiQueryHit", [queries] (uint32_t id)
+            {
+                auto& r = queries->Result(id);
+                return std::make_tuple(r.Hit, r.Entity, r.Point.x, r.Point.y, r.Point.z, 
+                    r.Normal.x, r.Normal.y, r.Normal.z, r.Distance);
+            });
+        }
+
+        // sampling profiler control, stacks written on stop
+        EMPY_INLINE void SetProfileFunctions()
+        {
+            m_Lua.set_function("ApiSampleStart", [] (sol::optional<uint32_t> hz)
+            {
+                return SampleProfiler::Get().Start(hz.value_or(1000u));
+            });
+
+            m_Lua.set_function("ApiSampleStop", [] (sol::optional<std::string> path)
+            {
+                return SampleProfiler::Get().WriteFolded(path.value_or("Resources/Profiles/samples.folded"));
+            });
+        }
+
     private:
         sol::state m_Lua;
     };
@@ -1,5 +1,6 @@
 #pragma once
 #include "Helpers.h"
+#include "Common/Profiler.h"
 
 namespace Empy
 {
@@ -8,11 +9,15 @@ namespace Empy
         // script handle constructor
         EMPY_INLINE Script(sol::table handle, const std::string& name): 
             m_Handle(handle), m_Name(name) 
-        {}
+        {
+            // looked up once, decides collision subscription
+            m_HasCollision = (m_Handle["OnCollision"].get_type() == sol::type::function);
+        }
 
         // callback for window resize event
         EMPY_INLINE void OnResize(int32_t width, int32_t height) 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnResize");
             if(m_Handle.valid())
             {
                 m_Handle["OnResize"](m_Handle, width, height);
@@ -22,6 +27,7 @@ namespace Empy
         // callback for mouse down event
         EMPY_INLINE void OnMouseDown(int32_t button) 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnMouseDown");
             if(m_Handle.valid())
             {
                 m_Handle["OnMouseDown"](m_Handle, button); 
@@ -31,6 +37,7 @@ namespace Empy
         // callback for rigidbody collision 
         EMPY_INLINE void OnCollision(EntityID other) 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnCollision");
             if(m_Handle.valid())
             {
                 m_Handle["OnCollision"](m_Handle, other);
@@ -40,6 +47,7 @@ namespace Empy
         // callback for key down event
         EMPY_INLINE void OnKeyDown(int32_t key) 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnKeyDown");
             if(m_Handle.valid())
             {
                 m_Handle["OnKeyDown"](m_Handle, key); 
@@ -49,6 +57,7 @@ namespace Empy
         // callback to update script 
         EMPY_INLINE void OnUpdate(float dt) 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnUpdate");
             if(m_Handle.valid())
             {
                 m_Handle["OnUpdate"](m_Handle, dt);
@@ -58,6 +67,7 @@ namespace Empy
         // callback to destroy entity 
         EMPY_INLINE void OnDestroy() 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnDestroy");
             if(m_Handle.valid())
             {
                 m_Handle["OnDestroy"](m_Handle); 
@@ -67,6 +77,7 @@ namespace Empy
         // callback sto tart script 
         EMPY_INLINE void OnStart() 
         { 
+            EMPY_PROFILE_SCOPE("Script::OnStart");
             if(m_Handle.valid())
             {
                 m_Handle["OnStart"](m_Handle); 
@@ -85,8 +96,15 @@ namespace Empy
             return m_Handle.valid(); 
         }
 
+        // checks if script defines OnCollision
+        EMPY_INLINE bool HasCollision() 
+        { 
+            return m_HasCollision; 
+        }
+
     private:
         friend struct ScriptContext;
+        bool m_HasCollision = false;
         sol::table m_Handle;
         std::string m_Name;
     };
@@ -0,0 +1,216 @@
+#pragma once
+#include "Inputs.h"
+#include <cstring>
+
+namespace Empy
+{
+    enum class InputType : uint8_t
+    {
+        KEY = 0,
+        MOUSE,
+        MOTION,
+        WHEEL,
+        RESIZE
+    };
+
+    // raw window input, before it becomes dispatcher events
+    struct InputEvent
+    {
+        InputType Type = InputType::KEY;
+        // key or button, width for resize
+        int32_t Code = 0;
+        // glfw action, height for resize
+        int32_t Action = 0;
+        double X = 0.0;
+        double Y = 0.0;
+    };
+
+    // binary log of per-frame delta time and inputs
+    struct InputLog
+    {
+        static constexpr uint32_t MAGIC = 0x43525945u;
+        static constexpr uint32_t VERSION = 1u;
+
+        EMPY_INLINE InputLog() = default;
+
+        EMPY_INLINE ~InputLog()
+        {
+            if(m_Output.is_open()) { m_Output.flush(); }
+        }
+
+        // starts a new log, seed is stored for the replay
+        EMPY_INLINE bool Record(const std::string& path, uint64_t seed)
+        {
+            m_Output.open(path, std::ios::binary | std::ios::trunc);
+            if(!m_Output)
+            {
+                EMPY_ERROR("failed to create input log: {}", path);
+                return false;
+            }
+
+            Write(MAGIC);
+            Write(VERSION);
+            Write(seed);
+            m_Seed = seed;
+            return true;
+        }
+
+        // reads the whole log, frames are handed out by NextFrame()
+        EMPY_INLINE bool Replay(const std::string& path)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if(!stream)
+            {
+                EMPY_ERROR("failed to open input log: {}", path);
+                return false;
+            }
+
+            m_Data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            m_Cursor = 0u;
+
+            uint32_t magic = 0u, version = 0u;
+            if(!Read(magic) || !Read(version) || !Read(m_Seed) ||
+                magic != MAGIC || version != VERSION)
+            {
+                EMPY_ERROR("invalid input log: {}", path);
+                m_Data.clear();
+                return false;
+            }
+            m_Replaying = true;
+            return true;
+        }
+
+        EMPY_INLINE bool IsRecording() const
+        {
+            return m_Output.is_open();
+        }
+
+        EMPY_INLINE bool IsReplaying() const
+        {
+            return m_Replaying;
+        }
+
+        EMPY_INLINE uint64_t Seed() const
+        {
+            return m_Seed;
+        }
+
+        // delta time of the frame last read by NextFrame()
+        EMPY_INLINE double DeltaTime() const
+        {
+            return m_DeltaTime;
+        }
+
+        // buffers an input of the current frame
+        EMPY_INLINE void Push(const InputEvent& event)
+        {
+            if(IsRecording()) { m_Events.push_back(event); }
+        }
+
+        // writes delta time and buffered inputs of the frame
+        EMPY_INLINE void EndFrame(double deltaTime)
+        {
+            if(!IsRecording()) { return; }
+
+            Write(deltaTime);
+            Write(static_cast<uint32_t>(m_Events.size()));
+            for(auto& event : m_Events)
+            {
+                Write(event.Type);
+                switch(event.Type)
+                {
+                    case InputType::KEY:
+                    case InputType::MOUSE:
+                        Write(event.Code);
+                        Write(static_cast<uint8_t>(event.Action));
+                    break;
+
+                    case InputType::RESIZE:
+                        Write(event.Code);
+                        Write(event.Action);
+                    break;
+
+                    case InputType::MOTION:
+                    case InputType::WHEEL:
+                        Write(event.X);
+                        Write(event.Y);
+                    break;
+                }
+            }
+            m_Events.clear();
+        }
+
+        // task(const InputEvent&) per input of the next frame, false at the end
+        template <typename Task>
+        EMPY_INLINE bool NextFrame(Task&& task)
+        {
+            uint32_t count = 0u;
+            if(!m_Replaying || !Read(m_DeltaTime) || !Read(count))
+            {
+                m_Replaying = false;
+                return false;
+            }
+
+            for(uint32_t i = 0u; i < count; i++)
+            {
+                InputEvent event;
+                uint8_t action = 0u;
+                bool valid = Read(event.Type);
+
+                switch(event.Type)
+                {
+                    case InputType::KEY:
+                    case InputType::MOUSE:
+                        valid = valid && Read(event.Code) && Read(action);
+                        event.Action = action;
+                    break;
+
+                    case InputType::RESIZE:
+                        valid = valid && Read(event.Code) && Read(event.Action);
+                    break;
+
+                    case InputType::MOTION:
+                    case InputType::WHEEL:
+                        valid = valid && Read(event.X) && Read(event.Y);
+                    break;
+
+                    default: valid = false;
+                }
+
+                if(!valid)
+                {
+                    EMPY_ERROR("truncated input log!");
+                    m_Replaying = false;
+                    return false;
+                }
+                task(event);
+            }
+            return true;
+        }
+
+    private:
+        template <typename T>
+        EMPY_INLINE void Write(const T& value)
+        {
+            m_Output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        EMPY_INLINE bool Read(T& value)
+        {
+            if(m_Cursor + sizeof(T) > m_Data.size()) { return false; }
+            std::memcpy(&value, m_Data.data() + m_Cursor, sizeof(T));
+            m_Cursor += sizeof(T);
+            return true;
+        }
+
+    private:
+        std::vector<InputEvent> m_Events;
+        std::vector<char> m_Data;
+        std::ofstream m_Output;
+        bool m_Replaying = false;
+        double m_DeltaTime = 0.0;
+        uint64_t m_Seed = 0u;
+        size_t m_Cursor = 0u;
+    };
+}
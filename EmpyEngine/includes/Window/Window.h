@@ -1,5 +1,6 @@
 #pragma once
 #include "Events.h"
+#include "Replay.h"
 
 namespace Empy
 {
@@ -56,6 +57,11 @@ namespace Empy
             glfwSwapInterval(1);             
         }       
 
+        // headless window, no display and no gl context
+        EMPY_INLINE AppWindow(EventDispatcher* dispatcher):
+        m_Dispatcher(dispatcher), m_Handle(nullptr)
+        {}
+
         EMPY_INLINE bool IsMouse(int32_t button)
         {
             if(button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST)
@@ -77,40 +83,84 @@ namespace Empy
 
         EMPY_INLINE bool PollEvents()
         {
-            glfwPollEvents();      
+            if(m_Handle) { glfwPollEvents(); }
+
+            // recorded frame stands in for live input, ends the run when done
+            if(m_Log.IsReplaying() && !m_Log.NextFrame([this] 
+            (auto& event) { ProcessInput(event); }))
+            {
+                return false;
+            }
+
+            if(!m_Handle)
+            {
+                m_Dispatcher->PollEvents();
+                return true;
+            }
+
             m_Dispatcher->PollEvents();
             glfwSwapBuffers(m_Handle);                  
             return (!glfwWindowShouldClose(m_Handle));
         }
 
+        // input log being recorded or replayed
+        EMPY_INLINE InputLog& Log()
+        {
+            return m_Log;
+        }
+
+        EMPY_INLINE bool IsHeadless() const
+        {
+            return (m_Handle == nullptr);
+        }
+
         EMPY_INLINE ~AppWindow()
         {
+            if(!m_Handle) { return; }
             glfwDestroyWindow(m_Handle);
             glfwTerminate();
         }  
 
     private:
-        EMPY_INLINE static void OnKey(GLFWwindow* window, int32_t key, int32_t, int32_t action, int32_t) 
+        // live input, dropped while a log is replayed
+        EMPY_INLINE void OnInput(const InputEvent& event)
+        {
+            if(!m_Log.IsReplaying()) { ProcessInput(event); }
+        }
+
+        // turns raw input into events, same path for live and replayed input
+        EMPY_INLINE void ProcessInput(const InputEvent& event)
+        {
+            m_Log.Push(event);
+            switch(event.Type)
+            {
+                case InputType::KEY: ProcessKey(event.Code, event.Action); break;
+                case InputType::MOUSE: ProcessMouse(event.Code, event.Action); break;
+                case InputType::MOTION: ProcessMotion(event.X, event.Y); break;
+                case InputType::WHEEL: m_Dispatcher->PostEvent<MouseWheelEvent>(event.X, event.Y); break;
+                case InputType::RESIZE: m_Dispatcher->PostEvent<WindowResizeEvent>(event.Code, event.Action); break;
+            }
+        }
+
+        EMPY_INLINE void ProcessKey(int32_t key, int32_t action) 
         {    
-            AppWindow* self = GetUserData(window); 
-            
             if(key >= 0 && key <= GLFW_KEY_LAST) 
             {
                 switch (action) 
                 {
                     case GLFW_RELEASE: 
-                        self->m_Dispatcher->PostEvent<KeyReleaseEvent>(key); 
-                        self->m_Inputs.Keys.reset(key);
+                        m_Dispatcher->PostEvent<KeyReleaseEvent>(key); 
+                        m_Inputs.Keys.reset(key);
                     break;
 
                     case GLFW_PRESS: 
-                        self->m_Dispatcher->PostEvent<KeyPressEvent>(key); 
-                        self->m_Inputs.Keys.set(key);
+                        m_Dispatcher->PostEvent<KeyPressEvent>(key); 
+                        m_Inputs.Keys.set(key);
                     break;
 
                     case GLFW_REPEAT: 
-                        self->m_Dispatcher->PostEvent<KeyRepeatEvent>(key);
-                        self->m_Inputs.Keys.set(key);
+                        m_Dispatcher->PostEvent<KeyRepeatEvent>(key);
+                        m_Inputs.Keys.set(key);
                     break;            
                 }
                 return;
@@ -118,22 +168,20 @@ namespace Empy
             EMPY_ERROR("invalid key code detected: [{}]", key);  
         }
 
-        EMPY_INLINE static void OnMouse(GLFWwindow* window, int32_t button, int32_t action, int32_t) 
+        EMPY_INLINE void ProcessMouse(int32_t button, int32_t action) 
         {
-            AppWindow* self = GetUserData(window);
-
             if(button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST) 
             { 
                 switch (action) 
                 {
                     case GLFW_PRESS:
-                        self->m_Dispatcher->PostEvent<MouseDownEvent>(button);
-                        self->m_Inputs.Mouse.set(button);
+                        m_Dispatcher->PostEvent<MouseDownEvent>(button);
+                        m_Inputs.Mouse.set(button);
                     break;
 
                     case GLFW_RELEASE:
-                        self->m_Dispatcher->PostEvent<MouseReleaseEvent>(button);
-                        self->m_Inputs.Mouse.reset(button);
+                        m_Dispatcher->PostEvent<MouseReleaseEvent>(button);
+                        m_Inputs.Mouse.reset(button);
                     break;
                 }
                 return;
@@ -141,31 +189,45 @@ namespace Empy
             EMPY_WARN("Invalid key code detected: [{}]", button);  
         }
 
-        EMPY_INLINE static void OnResize(GLFWwindow* window, int32_t width, int32_t height) 
-        {
-            GetUserData(window)->m_Dispatcher->PostEvent<WindowResizeEvent>(width, height);
-        }
-
-        EMPY_INLINE static void OnMotion(GLFWwindow* window, double x, double y) 
+        EMPY_INLINE void ProcessMotion(double x, double y) 
         {
-            AppWindow* self = GetUserData(window);        
-            self->m_Dispatcher->PostEvent<MouseMotionEvent>(x, y);
+            m_Dispatcher->PostEvent<MouseMotionEvent>(x, y);
 
-            if (self->m_Inputs.Mouse.test(GLFW_MOUSE_BUTTON_LEFT)) 
+            if (m_Inputs.Mouse.test(GLFW_MOUSE_BUTTON_LEFT)) 
             {
-                self->m_Dispatcher->PostEvent<MouseDragEvent>(
-                    (self->m_Inputs.MouseX - x), 
-                    (self->m_Inputs.MouseY - y)
+                m_Dispatcher->PostEvent<MouseDragEvent>(
+                    (m_Inputs.MouseX - x), 
+                    (m_Inputs.MouseY - y)
                 );
             }
            
-            self->m_Inputs.MouseX = x; 
-            self->m_Inputs.MouseY = y;            
+            m_Inputs.MouseX = x; 
+            m_Inputs.MouseY = y;            
+        }
+
+        EMPY_INLINE static void OnKey(GLFWwindow* window, int32_t key, int32_t, int32_t action, int32_t) 
+        {    
+            GetUserData(window)->OnInput({ InputType::KEY, key, action });
+        }
+
+        EMPY_INLINE static void OnMouse(GLFWwindow* window, int32_t button, int32_t action, int32_t) 
+        {
+            GetUserData(window)->OnInput({ InputType::MOUSE, button, action });
+        }
+
+        EMPY_INLINE static void OnResize(GLFWwindow* window, int32_t width, int32_t height) 
+        {
+            GetUserData(window)->OnInput({ InputType::RESIZE, width, height });
+        }
+
+        EMPY_INLINE static void OnMotion(GLFWwindow* window, double x, double y) 
+        {
+            GetUserData(window)->OnInput({ InputType::MOTION, 0, 0, x, y });
         }
 
         EMPY_INLINE static void OnWheel(GLFWwindow* window, double x, double y) 
         {
-            GetUserData(window)->m_Dispatcher->PostEvent<MouseWheelEvent>(x, y);
+            GetUserData(window)->OnInput({ InputType::WHEEL, 0, 0, x, y });
         }
 
         EMPY_INLINE static void OnMaximize(GLFWwindow* window, int32_t action) 
@@ -211,5 +273,6 @@ namespace Empy
         EventDispatcher* m_Dispatcher;   
         WindowInputs m_Inputs;
         GLFWwindow* m_Handle;
+        InputLog m_Log;
     };
 }
\ No newline at end of file
@@ -3,7 +3,31 @@
 int32_t main(int32_t argc, char** argv) 
 {
     using namespace Empy;
-    auto app = new Application();
+    AppConfig config;
+
+    // --headless [scene] [ticks] runs simulation only
+    int32_t arg = 1;
+    if(argc > 1 && std::string(argv[1]) == "--headless")
+    {
+        config.Headless = true;
+        arg++;
+        if(arg < argc && argv[arg][0] != '-') { config.Scene = argv[arg++]; }
+        if(arg < argc && argv[arg][0] != '-') { config.Ticks = static_cast<uint32_t>(std::stoul(argv[arg++])); }
+    }
+
+    // --record log, --replay log, --seed n for repeatable runs
+    // --workers n, --pin 0|1 for the job system
+    for(; arg + 1 < argc; arg += 2)
+    {
+        std::string option = argv[arg];
+        if(option == "--record") { config.Record = argv[arg + 1]; }
+        else if(option == "--replay") { config.Replay = argv[arg + 1]; }
+        else if(option == "--seed") { config.Seed = std::stoull(argv[arg + 1]); }
+        else if(option == "--workers") { config.Workers = static_cast<uint32_t>(std::stoul(argv[arg + 1])); }
+        else if(option == "--pin") { config.PinWorkers = (std::string(argv[arg + 1]) != "0"); }
+    }
+
+    auto app = new Application(config);
     app->RunContext(true);
     EMPY_DELETE(app);
     return 0;
@@ -14,6 +14,16 @@ function EmpyScript.Destroy(entity)
     ApiDestroy(entity)
 end
 
+-- start stack sampling at rate hz
+function EmpyScript.StartSampling(hz)
+    return ApiSampleStart(hz)
+end
+
+-- stop sampling, writes folded stacks
+function EmpyScript.StopSampling(path)
+    return ApiSampleStop(path)
+end
+
 -- inits script class
 function Initializer()
     -- script class 
@@ -33,6 +43,16 @@ function Initializer()
         ApiApplyForce(self.Entity, force)
     end
     
+    -- queue raycast, returns id for QueryHit next frame
+    function ScriptKlass:Raycast(origin, direction, distance, mask)
+        return ApiRaycast(origin, direction, distance, mask)
+    end
+
+    -- hit, entity, px, py, pz, nx, ny, nz, distance
+    function ScriptKlass:QueryHit(id)
+        return ApiQueryHit(id)
+    end
+
     -- destroy self
     function ScriptKlass:Destroy()
         ApiDestroy(self.Entity)
@@ -18,13 +18,24 @@ out Vertex
   vec2 UVs;
 } vertex;
  
-uniform mat4 u_model;
+// world matrices of the batch, four texels each
+uniform samplerBuffer u_instances;
+uniform int u_instanceBase;
+
 uniform mat4 u_proj;
 uniform mat4 u_view;
 
 uniform mat4 u_joints[MAX_JOINTS];
 uniform bool u_hasJoints = false;
 
+// world matrix of the drawn instance
+mat4 InstanceMatrix()
+{
+  int base = (u_instanceBase + gl_InstanceID) * 4;
+  return mat4(texelFetch(u_instances, base), texelFetch(u_instances, base + 1), 
+    texelFetch(u_instances, base + 2), texelFetch(u_instances, base + 3));
+}
+
 void main() 
 {     
   mat4 transform = mat4(1.0);
@@ -40,7 +51,7 @@ void main()
   }
 
   vertex.UVs = a_uvs;
-  transform = u_model * transform;
+  transform = InstanceMatrix() * transform;
   vertex.Normal = mat3(transform) * a_normal;
   vertex.Position = (transform * vec4(a_position, 1.0)).xyz;
   gl_Position = u_proj * u_view * transform * vec4(a_position, 1.0);
@@ -58,6 +69,11 @@ const vec3 BLOOM_THRESHOD = vec3(0.2126, 0.7152, 0.0722);
 const float PI = 3.14159265358979323846;
 const int MAX_LIGHTS = 10;
 
+// cluster grid, must match LightClusters
+const int CLUSTER_X = 16;
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
+
 // direct light type
 struct DirectLight
 {
@@ -66,25 +82,6 @@ struct DirectLight
   vec3 Radiance;
 };
 
-// point light type
-struct PointLight
-{
-  float Intensity;
-  vec3 Position;
-  vec3 Radiance;
-};
-
-// spot light type
-struct SpotLight
-{
-  float Intensity;
-  vec3 Direction;
-  vec3 Position;
-  vec3 Radiance;
-  float FallOff;
-  float CutOff;
-};
-
 // material type
 struct Material
 {
@@ -123,17 +120,22 @@ in Vertex
   vec2 UVs;
 } vertex;
 
-// point light uniforms
+// direct light uniforms
 uniform DirectLight u_directLights[MAX_LIGHTS]; 
 uniform int u_nbrDirectLight; 
 
-// point light uniforms
-uniform PointLight u_pointLights[MAX_LIGHTS]; 
-uniform int u_nbrPointLight; 
+// point and spot lights, four texels each
+uniform samplerBuffer u_lightData;
+// offset and count per cluster
+uniform usamplerBuffer u_clusterData;
+uniform usamplerBuffer u_lightIndices;
 
-// spot light uniforms
-uniform SpotLight u_spotLights[MAX_LIGHTS]; 
-uniform int u_nbrSpotLight; 
+// near, far
+uniform vec2 u_clusterDepth;
+// log(depth) scale, bias
+uniform vec2 u_clusterSlice;
+// tile size in pixels
+uniform vec2 u_clusterTile;
 
 // auxiliary uniforms
 uniform Material u_material; 
@@ -245,54 +247,32 @@ vec3 ComputeDirectLights(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness,
   return result;
 }
 
-// compute point lights
-vec3 ComputePointLights(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness, float metallic) 
+// compute point and spot lights of the fragment cluster
+vec3 ComputeClusterLights(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness, float metallic) 
 {
-  vec3 result = vec3(0.0);
-
-  for (int i = 0; i < u_nbrSpotLight; ++i) 
-  {
-    // compute parameters
-    vec3 L = normalize(u_pointLights[i].Position - vertex.Position);
-    float NdotL = max(dot(N, L), 0.0);       
-    float NdotV = max(dot(N, V), 0.0);    
-    vec3 H = normalize(L + V);
-
-    // Cook-Torrance (BRDF)
-    float NDF = DistributionGGX(N, H, roughness);   
-    vec3 FS = FresnelSchlick(clamp(dot(H, V), 0.0, 1.0), F0);
-    float GS = GeometrySmithGGX(NdotV, NdotL, roughness);      
-
-    // diffuse light
-    vec3 diffuse = (vec3(1.0) - FS) * (1.0 - metallic);
-
-    // specular light
-    vec3 specular = (NDF * GS * FS) / max(4.0 * NdotV * NdotL, 0.0001); 
-
-    // light attenuation
-    float distance = length(u_pointLights[i].Position - vertex.Position);
-    float attenuation = u_pointLights[i].Intensity / (distance * distance); 
-
-    // combine components
-    result += (diffuse * albedo / PI + specular) * u_pointLights[i].Radiance * 
-    attenuation * NdotL; 
-
-    // break if max light
-    if (i >= MAX_LIGHTS - 1) { break; }
-  }
+  // linear view depth from the depth buffer value
+  float near = u_clusterDepth.x;
+  float far = u_clusterDepth.y;
+  float ndc = gl_FragCoord.z * 2.0 - 1.0;
+  float depth = (2.0 * near * far) / (far + near - ndc * (far - near));
 
-  return result;
-}
+  // cluster of the fragment
+  ivec3 cell = ivec3(gl_FragCoord.xy / u_clusterTile, log(depth) * u_clusterSlice.x + u_clusterSlice.y);
+  cell = clamp(cell, ivec3(0), ivec3(CLUSTER_X - 1, CLUSTER_Y - 1, CLUSTER_Z - 1));
+  uvec2 range = texelFetch(u_clusterData, cell.x + CLUSTER_X * (cell.y + CLUSTER_Y * cell.z)).rg;
 
-// compute spot lights
-vec3 ComputeSpotLights(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness, float metallic) 
-{
   vec3 result = vec3(0.0);
 
-  for (int i = 0; i < u_nbrSpotLight; ++i) 
+  for (uint i = 0u; i < range.y; ++i) 
   {
+    int index = int(texelFetch(u_lightIndices, int(range.x + i)).r) * 4;
+    vec4 position = texelFetch(u_lightData, index);
+    vec4 radiance = texelFetch(u_lightData, index + 1);
+    vec4 direction = texelFetch(u_lightData, index + 2);
+    vec4 cone = texelFetch(u_lightData, index + 3);
+
     // compute parameters
-    vec3 L = normalize(u_spotLights[i].Position - vertex.Position);
+    vec3 L = normalize(position.xyz - vertex.Position);
     float NdotL = max(dot(N, L), 0.0);       
     float NdotV = max(dot(N, V), 0.0);    
     vec3 H = normalize(L + V);
@@ -308,21 +288,24 @@ vec3 ComputeSpotLights(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness, fl
     // specular light
     vec3 specular = (NDF * GS * FS) / max(4.0 * NdotV * NdotL, 0.0001); 
 
+    // light attenuation, fades out at the culling range
+    float distance = length(position.xyz - vertex.Position);
+    float attenuation = position.w / (distance * distance); 
+    float fade = clamp(1.0 - pow(distance / radiance.w, 4.0), 0.0, 1.0);
+    attenuation *= fade * fade;
+
     // compute spot
-    float theta = dot(L, normalize(-u_spotLights[i].Direction));
-    float epsilon = (u_spotLights[i].FallOff - u_spotLights[i].CutOff);
-    float spotFactor = clamp((theta - u_spotLights[i].CutOff)/epsilon, 0.0, 1.0);
-    
-    // light attenuation
-    float distance = length(u_spotLights[i].Position - vertex.Position);
-    float attenuation = u_spotLights[i].Intensity / (distance * distance); 
+    if (direction.w > 0.0)
+    {
+      float theta = dot(L, normalize(-direction.xyz));
+      float epsilon = (cone.x - cone.y);
+      float spotFactor = clamp((theta - cone.y)/epsilon, 0.0, 1.0);
+      attenuation *= position.w * spotFactor;
+    }
 
     // combine components
-    result += (diffuse * albedo / PI + specular) * u_spotLights[i].Radiance * 
-    u_spotLights[i].Intensity * attenuation * NdotL * spotFactor; 
-
-    // break if max light
-    if (i >= MAX_LIGHTS - 1) { break; }
+    result += (diffuse * albedo / PI + specular) * radiance.rgb * 
+    attenuation * NdotL; 
   }
 
   return result;
@@ -412,8 +395,7 @@ void main()
   // lights contribution
   vec3 result = ComputeAmbientLight(N, V, F0, albedo, roughness, metallic);
   result += ComputeDirectLights(N, V, F0, albedo, roughness, metallic);
-  result += ComputePointLights(N, V, F0, albedo, roughness, metallic);
-  result += ComputeSpotLights(N, V, F0, albedo, roughness, metallic);
+  result += ComputeClusterLights(N, V, F0, albedo, roughness, metallic);
 
   // occlusion and emissive 
   result = (result * occlusion) + emissive;
@@ -2,11 +2,17 @@
 layout (location = 0) in vec3 a_position;
 
 uniform mat4 u_lightSpace;
-uniform mat4 u_model;
+
+// world matrices of the batch, four texels each
+uniform samplerBuffer u_instances;
+uniform int u_instanceBase;
 
 void main() 
 {
-  gl_Position = u_lightSpace * u_model * vec4(a_position, 1.0f);
+  int base = (u_instanceBase + gl_InstanceID) * 4;
+  mat4 model = mat4(texelFetch(u_instances, base), texelFetch(u_instances, base + 1), 
+    texelFetch(u_instances, base + 2), texelFetch(u_instances, base + 3));
+  gl_Position = u_lightSpace * model * vec4(a_position, 1.0f);
 }
 
 ++VERTEX++